@@ -0,0 +1,273 @@
+#ifndef CHOLESKYFACTOR_H
+#define CHOLESKYFACTOR_H
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <iostream>
+#include <Eigen/Dense>
+#include <Eigen/Core>
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Scope in which Eigen must not allocate on the heap. It is only checked when built with -DEIGEN_RUNTIME_NO_MALLOC, where an allocation fails an assertion
+ */
+
+class NoMallocScope
+{
+public:
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    //Whether allocation was allowed when entering the scope
+    bool was_allowed;
+#endif
+
+    //The constructor and the destructor are user-provided in every build, so that a scope variable is never reported as unused
+    NoMallocScope()
+    {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        was_allowed = internal::is_malloc_allowed();
+        internal::set_is_malloc_allowed(false);
+#endif
+    }
+
+    ~NoMallocScope()
+    {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+        internal::set_is_malloc_allowed(was_allowed);
+#endif
+    }
+};
+
+/**
+ * @brief Cholesky factor M = L*L^T of a symmetric positive definite matrix that grows one row and one column at a time
+ * @tparam MaxN : Maximum order known at compile time, so that the storage is fixed-size and never allocated on the heap, or Dynamic
+ */
+
+template<int MaxN = Dynamic>
+class CholeskyFactor
+{
+public:
+
+    //Lower triangular factor, only the leading n x n block is valid
+    Matrix<double,Dynamic,Dynamic,ColMajor,MaxN,MaxN> L;
+    //Order of the factorized matrix
+    int n;
+    //log(det(M)) accumulated from the diagonal of L
+    double log_det;
+
+    //Workspaces of the same capacity as L, so that no operation below allocates
+    mutable Matrix<double,Dynamic,1,ColMajor,MaxN,1> x;
+    mutable Matrix<double,Dynamic,1,ColMajor,MaxN,1> e;
+    Matrix<double,Dynamic,1,ColMajor,MaxN,1> w1;
+    Matrix<double,Dynamic,1,ColMajor,MaxN,1> w2;
+
+    /**
+     * @brief Constructor, the factor of an empty matrix
+     */
+    CholeskyFactor()
+    {
+        n = 0;
+        log_det = 0;
+    }
+
+    /**
+     * @brief Preallocate storage for matrices of order up to capacity
+     * @param capacity : Maximum order
+     */
+    void reserve(int capacity)
+    {
+        if(MaxN != Dynamic)
+        {
+            if(capacity > MaxN)
+            {
+                cout << "The order " << capacity << " exceeds the fixed capacity " << MaxN << " of the Cholesky factor!!!" << endl;
+                exit(1);
+            }
+            //The storage is fixed-size, so take all of it at once
+            capacity = MaxN;
+        }
+
+        if(L.rows() >= capacity)
+        {
+            return;
+        }
+
+        L.conservativeResize(capacity, capacity);
+        x.resize(capacity);
+        e.resize(capacity);
+        w1.resize(capacity);
+        w2.resize(capacity);
+    }
+
+    /**
+     * @brief Memory held by the factor and its workspaces
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        return (L.size() + x.size() + e.size() + w1.size() + w2.size())*sizeof(double);
+    }
+
+    /**
+     * @brief Schur complement of appending a row and a column to M
+     * @param b : New off-diagonal column, of size n
+     * @param c : New diagonal entry
+     * @param y : Output of size n, the solution of L*y = b, which becomes the new row of L
+     * @return c - b^T * M^{-1} * b
+     */
+    double schur_complement(const Ref<const Matrix<double,Dynamic,1>> &b, double c, Ref<Matrix<double,Dynamic,1>> y) const
+    {
+        assert(b.size() == n);
+        assert(y.size() == n);
+
+        y = b;
+        L.topLeftCorner(n,n).template triangularView<Lower>().solveInPlace(y);
+
+        return c - y.squaredNorm();
+    }
+
+    /**
+     * @brief Solve L*Y = B for a block of right-hand sides at once
+     * @param B : Right-hand sides with n rows, overwritten by Y
+     */
+    void solve_lower(Ref<Matrix<double,Dynamic,Dynamic>> B) const
+    {
+        assert(B.rows() == n);
+
+        L.topLeftCorner(n,n).template triangularView<Lower>().solveInPlace(B);
+    }
+
+    /**
+     * @brief Append a row and a column to M using the output of schur_complement()
+     * @param y : Solution of L*y = b
+     * @param s : Schur complement
+     */
+    void append(const Ref<const Matrix<double,Dynamic,1>> &y, double s)
+    {
+        assert(y.size() == n);
+        assert(s > 0);
+
+        if(L.rows() <= n)
+        {
+            //Grow geometrically so that appending is amortized O(n)
+            reserve(max(2*n, 4));
+        }
+
+        L.row(n).head(n) = y.transpose();
+        L(n,n) = sqrt(s);
+        log_det += log(s);
+        ++n;
+    }
+
+    /**
+     * @brief Ratio det(M')/det(M), where M' is M with its p-th row and column replaced
+     * @param p : Index of the replaced row and column
+     * @param u : Change of the p-th column, whose p-th entry is 0
+     * @param outside : u^T*M^{-1}*u of the part of the change outside M, when M is a diagonal block of a block-diagonal matrix
+     * and the new column also reaches the other blocks
+     * @return det(M')/det(M)
+     */
+    double replace_ratio(int p, const Ref<const Matrix<double,Dynamic,1>> &u, double outside = 0) const
+    {
+        assert(u.size() == n);
+        assert(p < n);
+
+        //M' = M + e_p*u^T + u*e_p^T, so by the matrix determinant lemma
+        //det(M')/det(M) = (1 + (M^{-1}u)_p)^2 - (u^T*M^{-1}*u) * (M^{-1})_pp
+        auto x_n = x.head(n);
+        x_n = u;
+        L.topLeftCorner(n,n).template triangularView<Lower>().solveInPlace(x_n);
+        double u_Minv_u = x_n.squaredNorm() + outside;
+        L.topLeftCorner(n,n).template triangularView<Lower>().transpose().solveInPlace(x_n);
+
+        //(M^{-1})_pp is the squared norm of L^{-1}*e_p, whose first p entries are 0
+        auto e_p = e.head(n-p);
+        e_p.setZero();
+        e_p(0) = 1;
+        L.block(p,p,n-p,n-p).template triangularView<Lower>().solveInPlace(e_p);
+        double Minv_pp = e_p.squaredNorm();
+
+        return (1+x_n(p))*(1+x_n(p)) - u_Minv_u*Minv_pp;
+    }
+
+    /**
+     * @brief Replace the p-th row and column of M in place with two rank-one modifications
+     * @param p : Index of the replaced row and column
+     * @param u : Change of the p-th column, whose p-th entry is 0
+     */
+    void replace(int p, const Ref<const Matrix<double,Dynamic,1>> &u)
+    {
+        assert(u.size() == n);
+        assert(p < n);
+
+        //e_p*u^T + u*e_p^T = (w1*w1^T - w2*w2^T)/2 with w1 = e_p+u, w2 = e_p-u
+        auto w1_n = w1.head(n);
+        auto w2_n = w2.head(n);
+        w1_n = u*sqrt(0.5);
+        w2_n = -w1_n;
+        w1_n(p) += sqrt(0.5);
+        w2_n(p) += sqrt(0.5);
+
+        //Update before downdate so that every intermediate matrix stays positive definite
+        rank_update(w1_n, 1);
+        rank_update(w2_n, -1);
+
+        recompute_log_det();
+    }
+
+    /**
+     * @brief Recompute log_det from the diagonal of L, after the factor has been modified in place
+     */
+    void recompute_log_det()
+    {
+        log_det = 0;
+        for(int i = 0; i < n; ++i)
+        {
+            log_det += 2*log(L(i,i));
+        }
+    }
+
+    /**
+     * @brief Rank-one modification M + sigma*w*w^T of the factorized matrix
+     * @param w : Modification vector of size n, overwritten during the computation
+     * @param sigma : 1 for an update, -1 for a downdate
+     */
+    void rank_update(Ref<Matrix<double,Dynamic,1>> w, double sigma)
+    {
+        assert(w.size() == n);
+
+        for(int j = 0; j < n; ++j)
+        {
+            double r = sqrt(L(j,j)*L(j,j) + sigma*w(j)*w(j));
+            double c = r/L(j,j);
+            double s = w(j)/L(j,j);
+            L(j,j) = r;
+
+            int m = n-j-1;
+            L.col(j).segment(j+1,m) = (L.col(j).segment(j+1,m) + sigma*s*w.segment(j+1,m))/c;
+            w.segment(j+1,m) = c*w.segment(j+1,m) - s*L.col(j).segment(j+1,m);
+        }
+    }
+
+    /**
+     * @brief Recompute the factor from scratch, in the storage of L
+     * @param M : Symmetric positive definite matrix
+     * @return Whether M is positive definite
+     */
+    bool factorize(const Ref<const Matrix<double,Dynamic,Dynamic>> &M)
+    {
+        reserve(M.rows());
+
+        n = M.rows();
+        L.topLeftCorner(n,n) = M;
+        Ref<Matrix<double,Dynamic,Dynamic>> L_n(L.topLeftCorner(n,n));
+        LLT<Ref<Matrix<double,Dynamic,Dynamic>>> llt(L_n);
+
+        recompute_log_det();
+        return llt.info() == Success;
+    }
+};
+
+#endif // CHOLESKYFACTOR_H
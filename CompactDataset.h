@@ -0,0 +1,263 @@
+#ifndef COMPACTDATASET_H
+#define COMPACTDATASET_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <iostream>
+#include <algorithm>
+
+#include "Point.h"
+
+using namespace std;
+
+/**
+ * @brief Coordinates of a dataset of numerical vectors stored contiguously in a selectable precision, to reduce the memory traffic of a scan.
+ * Points are decoded to double one at a time, so that distances are still accumulated in double.
+ */
+
+class CompactDataset
+{
+public:
+
+    //Storage precisions
+    enum Precision
+    {
+        Float64,
+        Float32,
+        BFloat16,   //The upper 16 bits of a float32
+        Int8        //Linear quantization with a scale and an offset per dimension
+    };
+
+    //Storage precision
+    Precision precision;
+
+    //Dimension
+    size_t dimension;
+
+    //Number of points
+    size_t n;
+
+    //Coordinates, point-major, only the array of the storage precision is used
+    vector<double> f64;
+    vector<float> f32;
+    vector<uint16_t> bf16;
+    vector<int8_t> i8;
+
+    //Int8: a coordinate is offset[d] + scale[d]*q
+    vector<double> scale;
+    vector<double> offset;
+
+    /**
+     * @brief Constructor, encode the coordinates of a dataset
+     * @param Dataset : Dataset of numerical vectors of the same dimension
+     * @param precision : Storage precision
+     */
+    CompactDataset(const vector<Point> &Dataset, Precision precision)
+    {
+        this->precision = precision;
+        n = Dataset.size();
+        dimension = n > 0 ? Dataset[0].dimension : 0;
+
+        switch(precision)
+        {
+            case Float64:
+                f64.resize(n*dimension);
+                break;
+            case Float32:
+                f32.resize(n*dimension);
+                break;
+            case BFloat16:
+                bf16.resize(n*dimension);
+                break;
+            case Int8:
+                i8.resize(n*dimension);
+                fit_int8(Dataset);
+                break;
+        }
+
+        for(size_t i = 0; i < n; ++i)
+        {
+            if(Dataset[i].type != 0 || Dataset[i].dimension != dimension)
+            {
+                cout << "Only numerical vectors of the same dimension can be stored in reduced precision!!!" << endl;
+                exit(1);
+            }
+
+            for(size_t d = 0; d < dimension; ++d)
+            {
+                double x = Dataset[i].coordinates[d];
+                size_t index = i*dimension + d;
+                switch(precision)
+                {
+                    case Float64:
+                        f64[index] = x;
+                        break;
+                    case Float32:
+                        f32[index] = x;
+                        break;
+                    case BFloat16:
+                        bf16[index] = to_bfloat16(x);
+                        break;
+                    case Int8:
+                        i8[index] = lround(max(-127.0, min(127.0, (x - offset[d])/scale[d])));
+                        break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Number of points
+     * @return Number of points
+     */
+    size_t size() const
+    {
+        return n;
+    }
+
+    /**
+     * @brief Memory used by the coordinates
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        return f64.size()*sizeof(double) + f32.size()*sizeof(float) + bf16.size()*sizeof(uint16_t) + i8.size()*sizeof(int8_t)
+            + (scale.size() + offset.size())*sizeof(double);
+    }
+
+    /**
+     * @brief Decode a point, reusing the storage of the output
+     * @param i : Position of the point in the dataset
+     * @param p : Output, a numerical vector of the dataset dimension
+     */
+    void decode(size_t i, Point &p) const
+    {
+        assert(i < n);
+
+        p.id = i;
+        p.type = 0;
+        double *x = p.own_coordinates(dimension);
+
+        size_t start = i*dimension;
+        for(size_t d = 0; d < dimension; ++d)
+        {
+            switch(precision)
+            {
+                case Float64:
+                    x[d] = f64[start+d];
+                    break;
+                case Float32:
+                    x[d] = f32[start+d];
+                    break;
+                case BFloat16:
+                    x[d] = from_bfloat16(bf16[start+d]);
+                    break;
+                case Int8:
+                    x[d] = offset[d] + scale[d]*i8[start+d];
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief Decode all points into one contiguous store
+     * @param vector_store : Output, the coordinates of the decoded points, which must be empty
+     * @param Dataset : Output dataset, whose points refer to vector_store
+     */
+    void decode_all(VectorStore &vector_store, vector<Point> &Dataset) const
+    {
+        vector_store.dimension = dimension;
+        vector_store.reserve(n);
+        Point p;
+        for(size_t i = 0; i < n; ++i)
+        {
+            decode(i, p);
+            vector_store.add_vector(p.coordinates);
+        }
+
+        Dataset.clear();
+        Dataset.reserve(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            Dataset.push_back(Point(i, vector_store, i));
+        }
+    }
+
+    /**
+     * @brief Name of a precision
+     * @param precision : Precision
+     * @return Name
+     */
+    static const char* name(Precision precision)
+    {
+        switch(precision)
+        {
+            case Float64:
+                return "float64";
+            case Float32:
+                return "float32";
+            case BFloat16:
+                return "bfloat16";
+            case Int8:
+                return "int8";
+        }
+        return "";
+    }
+
+    /**
+     * @brief Choose the scale and the offset of each dimension so that its range maps to [-127, 127]
+     * @param Dataset : Dataset
+     */
+    void fit_int8(const vector<Point> &Dataset)
+    {
+        vector<double> lo(dimension, INFINITY), hi(dimension, -INFINITY);
+        for(auto &p : Dataset)
+        {
+            for(size_t d = 0; d < dimension; ++d)
+            {
+                lo[d] = min(lo[d], p.coordinates[d]);
+                hi[d] = max(hi[d], p.coordinates[d]);
+            }
+        }
+
+        scale.resize(dimension);
+        offset.resize(dimension);
+        for(size_t d = 0; d < dimension; ++d)
+        {
+            offset[d] = (lo[d] + hi[d])/2;
+            scale[d] = hi[d] > lo[d] ? (hi[d] - lo[d])/254 : 1;
+        }
+    }
+
+    /**
+     * @brief Round a double to bfloat16, to nearest even
+     * @param x : Value
+     * @return Bits of the bfloat16
+     */
+    static uint16_t to_bfloat16(double x)
+    {
+        float f = x;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        bits += 0x7FFF + ((bits >> 16) & 1);
+        return bits >> 16;
+    }
+
+    /**
+     * @brief Widen a bfloat16
+     * @param h : Bits of the bfloat16
+     * @return Value
+     */
+    static double from_bfloat16(uint16_t h)
+    {
+        uint32_t bits = uint32_t(h) << 16;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+};
+
+#endif // COMPACTDATASET_H
@@ -0,0 +1,688 @@
+#ifndef FEATUREVECSUBFUNC_H
+#define FEATUREVECSUBFUNC_H
+
+#include <vector>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <iostream>
+#include <Eigen/Dense>
+#include <Eigen/Core>
+
+#include "SubmodularFunction.h"
+#include "CholeskyFactor.h"
+#include "KernelRow.h"
+#include "Point.h"
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Approximate version of GauVecSubFunc and LapVecSubFunc for large k.
+ * Each point x is mapped to D features phi(x) with k(x,y) ≈ phi(x)^T*phi(y), so that the kernel matrix is M ≈ I + a*Phi*Phi^T with one row of Phi per point.
+ * Then det(M) = det(I_D + a*Phi^T*Phi), and the D x D dual matrix is kept factorized, so that an arrival costs O(D^2) whatever the size of the solution set.
+ * D is the accuracy knob: the approximation error of the kernel decreases as O(1/sqrt(D)).
+ */
+
+class FeatureVecSubFunc final : public SubmodularFunction
+{
+public:
+
+    //Feature maps
+    enum Features
+    {
+        RandomFourier,  //Random Fourier features, phi_j(x) = sqrt(2/D)*cos(W_j^T*x + phase_j)
+        Nystrom         //Nystrom features against D landmarks, phi(x) = K_mm^{-1/2}*k_m(x)
+    };
+
+    //Parameters of the kernel a*exp(-gamma*r^2) or a*exp(-gamma*r), the same as GauVecSubFunc and LapVecSubFunc
+    KernelRow::Kernel kernel;
+    double a;
+    double gamma;
+    //The value is scale*log(det(M)), 1/2 for the Gaussian kernel and 1 for the Laplacian kernel
+    double scale;
+
+    //Feature map
+    Features features;
+    //Number of features
+    int D;
+    //Random Fourier features: frequencies, one per row, and phases
+    Matrix<double,Dynamic,Dynamic> W;
+    Matrix<double,Dynamic,1> phase;
+    //Nystrom features: landmarks, one per row, and K_mm^{-1/2}
+    Matrix<double,Dynamic,Dynamic> X_m;
+    Matrix<double,Dynamic,Dynamic> P;
+
+    //Data stored for acceleration to avoid repeated calculations
+    //Features of the solution set, one column per position in the solution set
+    Matrix<double,Dynamic,Dynamic> Phi_S;
+    //Cholesky factor of I_D + a*Phi_S^T*Phi_S
+    CholeskyFactor<> factor;
+    //Value of the current solution set
+    double fval;
+
+    //Features of the last evaluated point, which commit() installs without recomputation
+    Matrix<double,Dynamic,1> pending_phi;
+    //Features of a point computed by gain_upper_bound()
+    Matrix<double,Dynamic,1> bound_phi;
+    //Ticket and id of the point of bound_phi, which the evaluation of the same point reuses if no other evaluation has been issued since
+    size_t bound_ticket;
+    size_t bound_id;
+    //Ticket of the pending evaluation, 0 if it has been consumed or invalidated
+    size_t pending_ticket;
+    //Last issued ticket
+    size_t last_ticket;
+
+    //Workspaces
+    Matrix<double,Dynamic,1> u;
+    Matrix<double,Dynamic,1> v;
+    Matrix<double,Dynamic,1> k_m;
+
+    //Cholesky factor of I_D + a*Phi_A^T*Phi_A
+    CholeskyFactor<> factor_A;
+
+    //Workspaces of delta_A_cap_S_all(): positions of the solution set in the order of arrival, and the factor of the dual matrix of the points before each one
+    vector<size_t> by_id;
+    CholeskyFactor<> factor_prefix;
+
+    /**
+     * @brief Constructor with random Fourier features, for the kernel of GauVecSubFunc or LapVecSubFunc
+     * @param kernel : KernelRow::Gaussian as in GauVecSubFunc, or KernelRow::Laplacian as in LapVecSubFunc
+     * @param dimension : Vector dimension
+     * @param D : Number of features
+     * @param seed : Seed of the random frequencies
+     */
+    FeatureVecSubFunc(KernelRow::Kernel kernel, int dimension, int D, unsigned seed = 0)
+    {
+        double a, gamma, scale;
+        preset(kernel, dimension, a, gamma, scale);
+        init(kernel, a, gamma, scale, D, false);
+        sample_frequencies(dimension, seed);
+    }
+
+    /**
+     * @brief Constructor with random Fourier features, for any parameters of the kernel
+     * @param kernel : Expression of the kernel in KernelRow
+     * @param a : Parameter a of the kernel a*exp(-gamma*r^2) or a*exp(-gamma*r)
+     * @param gamma : Rate of the exponent
+     * @param scale : The value is scale*log(det(M))
+     * @param dimension : Vector dimension
+     * @param D : Number of features
+     * @param only_A : Whether the function only tracks A, as the sketch of the A of another function, so that the solution set must not be used
+     * @param seed : Seed of the random frequencies
+     */
+    FeatureVecSubFunc(KernelRow::Kernel kernel, double a, double gamma, double scale, int dimension, int D, bool only_A, unsigned seed = 0)
+    {
+        init(kernel, a, gamma, scale, D, only_A);
+        sample_frequencies(dimension, seed);
+    }
+
+    /**
+     * @brief Constructor with Nystrom features, for the kernel of GauVecSubFunc or LapVecSubFunc
+     * @param kernel : KernelRow::Gaussian as in GauVecSubFunc, or KernelRow::Laplacian as in LapVecSubFunc
+     * @param dimension : Vector dimension
+     * @param landmarks : Landmarks, whose number is the number of features
+     */
+    FeatureVecSubFunc(KernelRow::Kernel kernel, int dimension, const vector<Point> &landmarks)
+    {
+        double a, gamma, scale;
+        preset(kernel, dimension, a, gamma, scale);
+        init(kernel, a, gamma, scale, landmarks.size(), false);
+        features = Nystrom;
+
+        X_m.resize(D, dimension);
+        for(int i = 0; i < D; ++i)
+        {
+            X_m.row(i) = Map<const Matrix<double,1,Dynamic>>(landmarks[i].coordinates, dimension);
+        }
+
+        //K_mm^{-1/2} from the eigendecomposition, dropping the directions in which K_mm is singular
+        Matrix<double,Dynamic,Dynamic> K_mm(D, D);
+        for(int i = 0; i < D; ++i)
+        {
+            KernelRow::compute(kernel, 1, gamma, X_m.data(), X_m.rows(), D, landmarks[i].coordinates, dimension, K_mm.col(i).data());
+        }
+        SelfAdjointEigenSolver<Matrix<double,Dynamic,Dynamic>> eigen(K_mm);
+        Matrix<double,Dynamic,1> inv_sqrt = eigen.eigenvalues();
+        for(int i = 0; i < D; ++i)
+        {
+            inv_sqrt(i) = inv_sqrt(i) > 1e-10 ? 1/sqrt(inv_sqrt(i)) : 0;
+        }
+        P = eigen.eigenvectors()*inv_sqrt.asDiagonal()*eigen.eigenvectors().transpose();
+    }
+
+    /**
+     * @brief Parameters of the kernel of GauVecSubFunc or LapVecSubFunc
+     * @param kernel : KernelRow::Gaussian or KernelRow::Laplacian
+     * @param dimension : Vector dimension
+     * @param a : Output, parameter a of the kernel
+     * @param gamma : Output, rate of the exponent
+     * @param scale : Output, the value is scale*log(det(M))
+     */
+    static void preset(KernelRow::Kernel kernel, int dimension, double &a, double &gamma, double &scale)
+    {
+        if(kernel == KernelRow::Gaussian)
+        {
+            double l = 1/(2*sqrt(dimension));
+            a = 1;
+            gamma = 1/(2*l*l);
+            scale = 0.5;
+        }
+        else
+        {
+            a = 10;
+            gamma = 1;
+            scale = 1;
+        }
+    }
+
+    /**
+     * @brief Set the kernel parameters and the factors of the empty sets
+     * @param kernel : Kernel
+     * @param a : Parameter a of the kernel
+     * @param gamma : Rate of the exponent
+     * @param scale : The value is scale*log(det(M))
+     * @param D : Number of features
+     * @param only_A : Whether the function only tracks A, in which case the factor of the solution set is not allocated
+     */
+    void init(KernelRow::Kernel kernel, double a, double gamma, double scale, int D, bool only_A)
+    {
+        if(D <= 0)
+        {
+            cout << "The number of features must be positive!!!" << endl;
+            exit(1);
+        }
+
+        this->kernel = kernel;
+        this->a = a;
+        this->gamma = gamma;
+        this->scale = scale;
+        this->D = D;
+
+        if(!only_A)
+        {
+            factor.factorize(Matrix<double,Dynamic,Dynamic>::Identity(D, D));
+        }
+        factor_A.factorize(Matrix<double,Dynamic,Dynamic>::Identity(D, D));
+        pending_phi.resize(D);
+        bound_phi.resize(D);
+        u.resize(D);
+        v.resize(D);
+        k_m.resize(D);
+
+        fval = 0;
+        pending_ticket = 0;
+        last_ticket = 0;
+        bound_ticket = 0;
+        bound_id = SIZE_MAX;
+        store_A = only_A;
+        query = 0;
+    }
+
+    /**
+     * @brief Draw the frequencies and phases of the random Fourier features
+     * @param dimension : Vector dimension
+     * @param seed : Seed of the random frequencies
+     */
+    void sample_frequencies(int dimension, unsigned seed)
+    {
+        features = RandomFourier;
+
+        //Frequencies from the Fourier transform of the kernel: a normal distribution for the Gaussian kernel, a multivariate Cauchy distribution for the Laplacian kernel
+        mt19937 gen(seed);
+        normal_distribution<double> normal(0, 1);
+        uniform_real_distribution<double> uniform(0, 2*M_PI);
+        W.resize(D, dimension);
+        phase.resize(D);
+        for(int j = 0; j < D; ++j)
+        {
+            double radial = (kernel == KernelRow::Gaussian) ? sqrt(2*gamma) : gamma/abs(normal(gen));
+            for(int d = 0; d < dimension; ++d)
+            {
+                W(j,d) = radial*normal(gen);
+            }
+            phase(j) = uniform(gen);
+        }
+    }
+
+    /**
+     * @brief Calculate the value of the solution set
+     * @param cur_solution : Current solution set
+     * @return Value of the solution set
+     */
+    double operator()(const vector<Point> &cur_solution)
+    {
+        if(cur_solution.empty())
+        {
+            return 0;
+        }
+
+        return fval;
+    }
+
+    /**
+     * @brief Preallocate the features of the solution set
+     * @param capacity : Maximum size of the solution set plus one
+     */
+    void reserve(size_t capacity)
+    {
+        if(Phi_S.cols() >= (Index)capacity)
+        {
+            return;
+        }
+
+        Phi_S.conservativeResize(D, capacity);
+    }
+
+    /**
+     * @brief Compute the features of a point
+     * @param p : Point
+     * @param phi : Output, features of the point
+     */
+    void compute_features(const Point &p, Ref<Matrix<double,Dynamic,1>> phi)
+    {
+        if(features == RandomFourier)
+        {
+            phi.noalias() = W*Map<const Matrix<double,Dynamic,1>>(p.coordinates, p.dimension);
+            phi = sqrt(2.0/D)*(phi + phase).array().cos().matrix();
+        }
+        else
+        {
+            KernelRow::compute(kernel, 1, gamma, X_m.data(), X_m.rows(), D, p.coordinates, p.dimension, k_m.data());
+            phi.noalias() = P*k_m;
+        }
+    }
+
+    /**
+     * @brief Compute the features of a point into pending_phi, unless gain_upper_bound() has just computed them
+     * @param cur_point : Point
+     */
+    void prepare(const Point &cur_point)
+    {
+        if(bound_ticket != 0 && bound_ticket == last_ticket && bound_id == cur_point.id)
+        {
+            pending_phi = bound_phi;
+        }
+        else
+        {
+            compute_features(cur_point, pending_phi);
+        }
+    }
+
+    /**
+     * @brief Ratio det(C + a*phi*phi^T)/det(C), where C = L*L^T
+     * @param L : Cholesky factor of C
+     * @param phi : Features of the added point
+     * @return The ratio
+     */
+    double append_ratio(const CholeskyFactor<> &L, const Ref<const Matrix<double,Dynamic,1>> &phi)
+    {
+        //The factor of the solution set is not allocated when the function only tracks A
+        assert(L.n == D);
+
+        u = phi;
+        L.L.topLeftCorner(D,D).triangularView<Lower>().solveInPlace(u);
+
+        return 1 + a*u.squaredNorm();
+    }
+
+    /**
+     * @brief Ratio det(C + a*phi_new*phi_new^T - a*phi_old*phi_old^T)/det(C) by the matrix determinant lemma, where C = L*L^T
+     * @param phi_new : Features of the added point
+     * @param phi_old : Features of the removed point
+     * @return The ratio
+     */
+    double replace_ratio(const Ref<const Matrix<double,Dynamic,1>> &phi_new, const Ref<const Matrix<double,Dynamic,1>> &phi_old)
+    {
+        assert(factor.n == D);
+
+        u = phi_new;
+        v = phi_old;
+        factor.L.topLeftCorner(D,D).triangularView<Lower>().solveInPlace(u);
+        factor.L.topLeftCorner(D,D).triangularView<Lower>().solveInPlace(v);
+
+        double uv = u.dot(v);
+        return (1 + a*u.squaredNorm())*(1 - a*v.squaredNorm()) + a*a*uv*uv;
+    }
+
+    /**
+     * @brief Calculate the value after adding a point to the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @param position : Position for the point to be added
+     * @return Value after adding point
+     */
+    double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        Evaluation eval;
+        return peek(cur_solution, cur_point, position, eval);
+    }
+
+    /**
+     * @brief Calculate the value after adding a point to the solution set and keep its features for commit()
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @param position : Position for the point to be added
+     * @param eval : Output, handle of this evaluation
+     * @return Value after adding point
+     */
+    double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position, Evaluation &eval)
+    {
+        ++query;
+
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        prepare(cur_point);
+        pending_ticket = ++last_ticket;
+
+        double ratio;
+        if(position == cur_solution.size())
+        {
+            //Append
+            ratio = append_ratio(factor, pending_phi);
+        }
+        else
+        {
+            //Replace
+            ratio = replace_ratio(pending_phi, Phi_S.col(position));
+        }
+
+        eval.id = cur_point.id;
+        eval.position = position;
+        eval.ticket = pending_ticket;
+        eval.value = scale*(factor.log_det + log(ratio));
+
+        return eval.value;
+    }
+
+    /**
+     * @brief Upper bound of the marginal gain of appending a point, the value of the point alone
+     * The gain is scale*log(1 + a*phi^T * C^{-1} * phi) with C = I_D + a*Phi_S^T*Phi_S >= I_D, so only the features are needed
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Upper bound of the marginal gain
+     */
+    double gain_upper_bound(const vector<Point> &, const Point &cur_point)
+    {
+        //The features are kept apart from the pending evaluation, for the evaluation of the same point that follows
+        compute_features(cur_point, bound_phi);
+        bound_ticket = ++last_ticket;
+        bound_id = cur_point.id;
+
+        return scale*log(1 + a*bound_phi.squaredNorm());
+    }
+
+    /**
+     * @brief Calculate the marginal gains of appending each of a block of candidates to the solution set
+     * @param candidates : Points to be evaluated, each one separately
+     * @param fdeltas : Output, fdeltas[j] is the marginal gain of candidates[j]
+     */
+    void peek_many(const vector<Point> &, const vector<const Point*> &candidates, vector<double> &fdeltas)
+    {
+        query += candidates.size();
+
+        fdeltas.resize(candidates.size());
+
+        //Evaluate candidates in blocks to bound the memory of the features
+        const int block_size = 1024;
+        Matrix<double,Dynamic,Dynamic> Phi_C;
+        for(size_t start = 0; start < candidates.size(); start += block_size)
+        {
+            int C_size = min<size_t>(block_size, candidates.size()-start);
+
+            Phi_C.resize(D, C_size);
+            for(int j = 0; j < C_size; ++j)
+            {
+                compute_features(*candidates[start+j], Phi_C.col(j));
+            }
+
+            factor.solve_lower(Phi_C);
+            for(int j = 0; j < C_size; ++j)
+            {
+                fdeltas[start+j] = scale*log(1 + a*Phi_C.col(j).squaredNorm());
+            }
+        }
+    }
+
+    /**
+     * @brief Update the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void update(vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        prepare(cur_point);
+        install(cur_solution, cur_point, position);
+    }
+
+    /**
+     * @brief Update the solution set with the features kept by peek()
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     * @param eval : Handle returned by peek() for cur_point
+     */
+    void commit(vector<Point> &cur_solution, const Point &cur_point, size_t position, const Evaluation &eval)
+    {
+        //The features do not depend on the position
+        bool reusable = eval.ticket != 0 && eval.ticket == pending_ticket && eval.id == cur_point.id && position <= cur_solution.size();
+
+        if(!reusable)
+        {
+            update(cur_solution, cur_point, position);
+            return;
+        }
+
+        install(cur_solution, cur_point, position);
+    }
+
+    /**
+     * @brief Add a point whose features are in pending_phi to the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void install(vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        assert(factor.n == D);
+
+        if(position == cur_solution.size())
+        {
+            //Append
+            cur_solution.push_back(cur_point);
+            if(Phi_S.cols() <= (Index)position)
+            {
+                //Only reached when reserve() was not called with enough capacity
+                reserve(2*(position+1));
+            }
+
+            u = sqrt(a)*pending_phi;
+            factor.rank_update(u, 1);
+        }
+        else
+        {
+            //Replace, updating before downdating so that the dual matrix stays positive definite
+            cur_solution[position] = cur_point;
+
+            u = sqrt(a)*pending_phi;
+            factor.rank_update(u, 1);
+            v = sqrt(a)*Phi_S.col(position);
+            factor.rank_update(v, -1);
+        }
+        Phi_S.col(position) = pending_phi;
+        factor.recompute_log_det();
+
+        if(store_A)
+        {
+            //Update A
+            u = sqrt(a)*pending_phi;
+            factor_A.rank_update(u, 1);
+            factor_A.recompute_log_det();
+            fval_A = scale*factor_A.log_det;
+        }
+
+        //The pending evaluation has been consumed
+        pending_ticket = 0;
+
+        //Update fval
+        fval = scale*factor.log_det;
+    }
+
+    /**
+     * @brief Create a new submodular function
+     * @return Reference to the new submodular function
+     */
+    SubmodularFunction& new_object()
+    {
+        FeatureVecSubFunc *f = new FeatureVecSubFunc(*this);
+        return *f;
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Value after adding point
+     */
+    double peek_delta_A(const Point &cur_point)
+    {
+        ++query;
+
+        if(!store_A)
+        {
+            cout << "Did not store A!!! \n";
+            exit(1);
+        }
+
+        //The features of the pending evaluation are overwritten
+        pending_ticket = 0;
+        compute_features(cur_point, pending_phi);
+
+        return scale*log(append_ratio(factor_A, pending_phi));
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Add a point to A without changing the solution set, e.g. when this function summarizes the A of another one
+     * @param cur_point : Point that is added to A
+     * @return The delta_value of adding the point
+     */
+    double add_to_A(const Point &cur_point)
+    {
+        compute_features(cur_point, v);
+        double fdelta = scale*log(append_ratio(factor_A, v));
+
+        v *= sqrt(a);
+        factor_A.rank_update(v, 1);
+        factor_A.recompute_log_det();
+        fval_A = scale*factor_A.log_det;
+
+        return fdelta;
+    }
+
+    /**
+     * @brief Memory held by the features, the factors and the workspaces
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        return (W.size() + phase.size() + X_m.size() + P.size() + Phi_S.size() + pending_phi.size() + bound_phi.size() + u.size() + v.size() + k_m.size())*sizeof(double)
+            + factor.bytes() + factor_A.bytes() + factor_prefix.bytes() + by_id.capacity()*sizeof(size_t);
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Memory held to evaluate A
+     * @return Number of bytes of the Cholesky factor of A
+     */
+    size_t bytes_A() const
+    {
+        return factor_A.bytes();
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A \cap S
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Value after adding point
+     */
+    double peek_delta_A_cap_S(const vector<Point> &cur_solution, const Point &cur_point)
+    {
+        ++query;
+
+        //Dual matrix of the points in A \cap S, the points of S that arrived before cur_point
+        Matrix<double,Dynamic,Dynamic> C = Matrix<double,Dynamic,Dynamic>::Identity(D, D);
+        int cur_position = -1;
+        for(size_t i = 0; i < cur_solution.size(); ++i)
+        {
+            if(cur_solution[i].id < cur_point.id)
+            {
+                C.selfadjointView<Lower>().rankUpdate(Phi_S.col(i), a);
+            }
+            else if(cur_solution[i].id == cur_point.id)
+            {
+                cur_position = i;
+            }
+        }
+
+        if(cur_position < 0)
+        {
+            cout << "This point dosen't in the solution!!! \n";
+            exit(1);
+        }
+
+        LLT<Matrix<double,Dynamic,Dynamic>> llt(C);
+        u = Phi_S.col(cur_position);
+        llt.matrixL().solveInPlace(u);
+
+        return scale*log(1 + a*u.squaredNorm());
+    }
+
+    /**
+     * @brief Calculate the delta_value of every point of the solution set after adding it to A \cap S, in one pass in the order of arrival
+     * The dual matrix of the points so far is kept factorized and updated with the features of each point after scoring it
+     * @param cur_solution : Current solution set
+     * @param fdeltas : Output, fdeltas[i] is the delta_value of cur_solution[i]
+     */
+    void delta_A_cap_S_all(const vector<Point> &cur_solution, vector<double> &fdeltas)
+    {
+        query += cur_solution.size();
+
+        //Positions of the solution set in the order of arrival, in storage kept across calls
+        by_id.resize(cur_solution.size());
+        iota(by_id.begin(), by_id.end(), 0);
+        sort(by_id.begin(), by_id.end(), [&](size_t i, size_t j)->bool{
+            return cur_solution[i].id < cur_solution[j].id;
+        });
+
+        //Factor of the identity, set in place in storage that is only allocated by the first call
+        factor_prefix.reserve(D);
+        factor_prefix.n = D;
+        factor_prefix.L.topLeftCorner(D,D).setIdentity();
+        factor_prefix.log_det = 0;
+        fdeltas.resize(cur_solution.size());
+        for(size_t i : by_id)
+        {
+            fdeltas[i] = scale*log(append_ratio(factor_prefix, Phi_S.col(i)));
+
+            v = sqrt(a)*Phi_S.col(i);
+            factor_prefix.rank_update(v, 1);
+        }
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~FeatureVecSubFunc() {}
+};
+
+#endif // FEATUREVECSUBFUNC_H
@@ -12,9 +12,15 @@
 
 using namespace std;
 
-class FreeDisposal : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class FreeDisposalT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
+
+    //Contributions of the points of the solution set to A \cap S, reused across arrivals
+    vector<double> fdeltas_A_cap_S;
 
     //Parameters that determine the thresholds
     double alpha, beta, gamma;
@@ -24,7 +30,7 @@ public:
      * @param k: Cardinality constraint
      * @param f: Submodular function
      */
-    FreeDisposal(size_t k, SubmodularFunction &f) : SubsetSelectionAlgorithm(k, f)
+    FreeDisposalT(size_t k, F &f) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f))
     {
         this->f.store_A=true;
         //alpha is the unique root in the interval (3, 4) of the equation: $x = (1+\frac{x - 2}{k+1})^{k+1}$
@@ -91,10 +97,12 @@ public:
                 //Record the information of the replaced point
                 double fdelta_min;//Value     
                 size_t fdelta_min_position;//The position in the solution set
+                //Contributions of all points of the solution set, computed together
+                f.delta_A_cap_S_all(solution, fdeltas_A_cap_S);
                 //Traverse the solution set
                 for (size_t i = 0; i < solution.size(); ++i)
                 {
-                    double fdelta_temp = f.peek_delta_A_cap_S(solution, solution[i]);
+                    double fdelta_temp = fdeltas_A_cap_S[i];
 
                     //Update the information on the replaced point
                     if(i == 0)
@@ -119,7 +127,9 @@ public:
     /**
      * @brief Destructor
      */
-    ~FreeDisposal() {}
+    ~FreeDisposalT() {}
 };
 
+typedef FreeDisposalT<> FreeDisposal;
+
 #endif
\ No newline at end of file
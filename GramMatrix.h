@@ -0,0 +1,297 @@
+#ifndef GRAMMATRIX_H
+#define GRAMMATRIX_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <Eigen/Dense>
+
+#include "KernelRow.h"
+#include "Point.h"
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Kernel values between all pairs of points of a dataset, in float, read from a memory-mapped file.
+ * The file is named after a hash of the dataset and the kernel parameters. It is built in parallel the first time
+ * and mapped directly afterwards, so that later runs on the same dataset never compute a distance.
+ * Only the lower triangle is stored, row by row, which takes 2*n*(n+1) bytes.
+ */
+
+class GramMatrix
+{
+public:
+
+    //Header of the file, followed by the lower triangle
+    struct Header
+    {
+        char magic[8];
+        uint64_t n;
+        uint64_t hash;
+        int64_t kernel;
+        double a;
+        double gamma;
+        char padding[16];
+    };
+
+    //Number of points
+    size_t n;
+    //Hash of the dataset and the kernel parameters
+    uint64_t hash;
+    //Path of the file
+    string path;
+    //Whether the file was built by this object rather than found on disk
+    bool built;
+
+    //The mapped file and its lower triangle
+    void *mapping;
+    size_t mapping_bytes;
+    const float *values;
+
+    /**
+     * @brief Constructor, map the file of the dataset or build it if it does not exist
+     * @param Dataset : Dataset of numerical vectors, the point with id i being Dataset[i]
+     * @param kernel : Kernel expression
+     * @param a : Scale of the kernel
+     * @param gamma : Rate of the kernel
+     * @param directory : Directory of the files
+     * @param threads : Number of threads that build the file
+     */
+    GramMatrix(const vector<Point> &Dataset, KernelRow::Kernel kernel, double a, double gamma, const string &directory, unsigned threads = thread::hardware_concurrency())
+    {
+        n = Dataset.size();
+        hash = dataset_hash(Dataset, kernel, a, gamma);
+        char name[64];
+        snprintf(name, sizeof(name), "/gram_%016llx.bin", (unsigned long long)hash);
+        path = directory + name;
+        built = false;
+        mapping = nullptr;
+        mapping_bytes = 0;
+        values = nullptr;
+
+        if(!map_file(kernel, a, gamma))
+        {
+            build(Dataset, kernel, a, gamma, directory, max(1u, threads));
+            built = true;
+            if(!map_file(kernel, a, gamma))
+            {
+                cout << "Cannot map the Gram matrix " << path << "!!!" << endl;
+                exit(1);
+            }
+        }
+    }
+
+    GramMatrix(const GramMatrix&) = delete;
+    GramMatrix& operator=(const GramMatrix&) = delete;
+
+    /**
+     * @brief Kernel value between two points
+     * @param i : Id of a point
+     * @param j : Id of the other point
+     * @return Kernel value
+     */
+    double at(size_t i, size_t j) const
+    {
+        if(i < j)
+        {
+            swap(i, j);
+        }
+        assert(i < n);
+        return values[i*(i+1)/2 + j];
+    }
+
+    /**
+     * @brief Size of the file
+     * @param n : Number of points
+     * @return Number of bytes
+     */
+    static size_t file_bytes(size_t n)
+    {
+        return sizeof(Header) + n*(n+1)/2*sizeof(float);
+    }
+
+    /**
+     * @brief FNV-1a hash of the coordinates of a dataset and the kernel parameters
+     * @param Dataset : Dataset of numerical vectors
+     * @param kernel : Kernel expression
+     * @param a : Scale of the kernel
+     * @param gamma : Rate of the kernel
+     * @return Hash
+     */
+    static uint64_t dataset_hash(const vector<Point> &Dataset, KernelRow::Kernel kernel, double a, double gamma)
+    {
+        uint64_t h = 0xCBF29CE484222325ULL;
+        auto mix = [&h](const void *data, size_t bytes)
+        {
+            const unsigned char *c = (const unsigned char*)data;
+            for(size_t i = 0; i < bytes; ++i)
+            {
+                h = (h ^ c[i])*0x100000001B3ULL;
+            }
+        };
+
+        uint64_t n = Dataset.size();
+        int64_t kernel_id = kernel;
+        mix(&n, sizeof(n));
+        mix(&kernel_id, sizeof(kernel_id));
+        mix(&a, sizeof(a));
+        mix(&gamma, sizeof(gamma));
+        for(auto &p : Dataset)
+        {
+            mix(p.coordinates, p.dimension*sizeof(double));
+        }
+        return h;
+    }
+
+    /**
+     * @brief Map the file and check that it belongs to this dataset and kernel
+     * @param kernel : Kernel expression
+     * @param a : Scale of the kernel
+     * @param gamma : Rate of the kernel
+     * @return Whether a valid file was mapped
+     */
+    bool map_file(KernelRow::Kernel kernel, double a, double gamma)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st;
+        if(fstat(fd, &st) != 0 || (size_t)st.st_size != file_bytes(n))
+        {
+            close(fd);
+            return false;
+        }
+
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        const Header *header = (const Header*)data;
+        if(memcmp(header->magic, "GRAMF32", 8) != 0 || header->n != n || header->hash != hash
+            || header->kernel != kernel || header->a != a || header->gamma != gamma)
+        {
+            munmap(data, st.st_size);
+            return false;
+        }
+
+        mapping = data;
+        mapping_bytes = st.st_size;
+        values = (const float*)((const char*)data + sizeof(Header));
+        return true;
+    }
+
+    /**
+     * @brief Compute the lower triangle into a temporary file, in blocks of rows shared by the threads, and move it to the path
+     * @param Dataset : Dataset of numerical vectors
+     * @param kernel : Kernel expression
+     * @param a : Scale of the kernel
+     * @param gamma : Rate of the kernel
+     * @param directory : Directory of the files, created if needed
+     * @param threads : Number of threads
+     */
+    void build(const vector<Point> &Dataset, KernelRow::Kernel kernel, double a, double gamma, const string &directory, unsigned threads)
+    {
+        mkdir(directory.c_str(), 0755);
+
+        string tmp_path = path + ".tmp";
+        int fd = open(tmp_path.c_str(), O_RDWR|O_CREAT|O_TRUNC, 0644);
+        if(fd < 0 || ftruncate(fd, file_bytes(n)) != 0)
+        {
+            cout << "Cannot create the Gram matrix " << tmp_path << "!!!" << endl;
+            exit(1);
+        }
+        void *data = mmap(nullptr, file_bytes(n), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED)
+        {
+            cout << "Cannot map the Gram matrix " << tmp_path << "!!!" << endl;
+            exit(1);
+        }
+
+        //All points dimension-major for KernelRow
+        size_t dim = n > 0 ? Dataset[0].dimension : 0;
+        Matrix<double,Dynamic,Dynamic> X(n, dim);
+        for(size_t i = 0; i < n; ++i)
+        {
+            X.row(i) = Map<const Matrix<double,1,Dynamic>>(Dataset[i].coordinates, dim);
+        }
+
+        //Row i holds the kernel values with points 0..i, so the rows are handed out in small blocks to balance the threads
+        float *out = (float*)((char*)data + sizeof(Header));
+        const size_t block_size = 64;
+        atomic<size_t> next_row(0);
+        auto work = [&]()
+        {
+            vector<double> row(n);
+            for(size_t start = next_row.fetch_add(block_size); start < n; start = next_row.fetch_add(block_size))
+            {
+                for(size_t i = start; i < min(start + block_size, n); ++i)
+                {
+                    KernelRow::compute(kernel, a, gamma, X.data(), n, i+1, Dataset[i].coordinates, dim, row.data());
+                    copy(row.begin(), row.begin() + i+1, out + i*(i+1)/2);
+                }
+            }
+        };
+
+        vector<thread> workers;
+        for(unsigned t = 1; t < threads; ++t)
+        {
+            workers.emplace_back(work);
+        }
+        work();
+        for(auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        //The header is written last, so that an interrupted build leaves no valid file
+        Header *header = (Header*)data;
+        memset(header, 0, sizeof(Header));
+        memcpy(header->magic, "GRAMF32", 8);
+        header->n = n;
+        header->hash = hash;
+        header->kernel = kernel;
+        header->a = a;
+        header->gamma = gamma;
+
+        msync(data, file_bytes(n), MS_SYNC);
+        munmap(data, file_bytes(n));
+        if(rename(tmp_path.c_str(), path.c_str()) != 0)
+        {
+            cout << "Cannot move the Gram matrix to " << path << "!!!" << endl;
+            exit(1);
+        }
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~GramMatrix()
+    {
+        if(mapping)
+        {
+            munmap(mapping, mapping_bytes);
+        }
+    }
+};
+
+#endif // GRAMMATRIX_H
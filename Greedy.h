@@ -12,16 +12,19 @@
 
 using namespace std;
 
-class Greedy : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class GreedyT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
 
     /**
      * @brief Constructor
      * @param k: Cardinality constraint
      * @param f: Submodular function 
      */
-    Greedy(size_t k, SubmodularFunction &f) : SubsetSelectionAlgorithm(k, f)
+    GreedyT(size_t k, F &f) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f))
     {
 
     }
@@ -42,23 +45,34 @@ public:
             ++id_temp;
         }
 
+        //Points in the remaining dataset and their marginal gains
+        vector<const Point*> candidates;
+        vector<double> fdeltas;
+
         //Start multiple rounds of traversal
         while (solution.size() < k && Dataset_remaining.size() > 0)
         {
+            //Evaluate all remaining points in one batch
+            candidates.clear();
+            for (auto it = Dataset_remaining.begin(); it != Dataset_remaining.end(); ++it)
+            {
+                candidates.push_back(&Dataset[*it]);
+            }
+            f.peek_many(solution, candidates, fdeltas);
+
             //Record the information of the point with maximum marginal gain among the current remaining points
-            double fval_max = 0;//marginal gain     
+            double fdelta_max = fdeltas[0];//marginal gain     
             size_t fval_max_id = Dataset_remaining.front();//The position in the original dataset 
             auto fval_max_it = Dataset_remaining.begin();//Iterator 
 
             //Traverse the remaining dataset
-            for (auto it = Dataset_remaining.begin(); it != Dataset_remaining.end(); ++it)
+            size_t j = 0;
+            for (auto it = Dataset_remaining.begin(); it != Dataset_remaining.end(); ++it, ++j)
             {
-                double fval_temp = f.peek(solution, Dataset[*it], solution.size());
-
                 //Update the information
-                if(fval_temp > fval_max)
+                if(fdeltas[j] > fdelta_max)
                 {
-                    fval_max = fval_temp;
+                    fdelta_max = fdeltas[j];
                     fval_max_id = *it;
                     fval_max_it = it;
                 }
@@ -71,10 +85,22 @@ public:
             Dataset_remaining.erase(fval_max_it);
 
             //Update the value of the current solution set
-            fval = fval_max;
+            fval = f.operator()(solution);
         }
     }
 
+    /**
+     * @brief Run the submodular algorithm on a dataset stored in reduced precision. Greedy needs all points in every round, so they are decoded first
+     * @param Dataset: Dataset
+     */
+    void run_compact(const CompactDataset &Dataset)
+    {
+        VectorStore vector_store;
+        vector<Point> Decoded;
+        Dataset.decode_all(vector_store, Decoded);
+        run(Decoded);
+    }
+
     /**
      * @brief Process streaming data, but Greedy does not support it and will throw an exception
      * @param cur_point: The current point in the data flow
@@ -87,7 +113,9 @@ public:
     /**
      * @brief Destructor
      */
-    ~Greedy() {}
+    ~GreedyT() {}
 };
 
+typedef GreedyT<> Greedy;
+
 #endif // GREEDY_H
@@ -2,109 +2,484 @@
 #define __IOUTIL_H__
 
 #include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
 #include <vector>
+#include <string>
+#include <chrono>
+#include <charconv>
+#include <system_error>
 #include <iostream>
-#include <set>
-#include <iomanip>
-#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "Point.h"
+#include "VectorStore.h"
+#include "TokenStore.h"
 
 using namespace std;
 
+/**
+ * @brief Readers of the datasets. A file is mapped into memory and its numbers are parsed in place with from_chars,
+ * which does not depend on the locale, so that reading allocates nothing per line and lines may be of any length.
+ * A dataset of numerical vectors can also be cached in a binary file next to its text file, which later runs map
+ * and read in place instead of parsing the text again.
+ */
+
 class IOUtil
 {
 public:
+
+    //Size of a file and the time taken to read it
+    struct LoadStats
+    {
+        size_t bytes;
+        double seconds;
+
+        /**
+         * @brief Throughput of the reading
+         * @return Megabytes per second
+         */
+        double megabytes_per_second() const
+        {
+            return seconds > 0 ? bytes/1e6/seconds : 0;
+        }
+    };
+
+    //Header of the binary cache of a dataset of numerical vectors, followed by the n*dim coordinates, vector by vector,
+    //in the byte order of the machine
+    struct VectorCacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t dtype;
+        uint64_t n;
+        uint64_t dim;
+        uint64_t checksum;
+        char padding[24];
+    };
+
+    //Types of the coordinates in the cache, only double so far
+    enum CacheType{FLOAT64 = 0};
+    //Version of the layout of the cache
+    static const uint32_t cache_version = 2;
+
+    //A file mapped into memory for reading
+    struct MappedFile
+    {
+        const char *data;
+        size_t bytes;
+
+        /**
+         * @brief Constructor, map a whole file
+         * @param file_path : File path
+         */
+        MappedFile(const char *file_path)
+        {
+            data = nullptr;
+            bytes = 0;
+
+            int fd = open(file_path, O_RDONLY);
+            struct stat st;
+            if(fd < 0 || fstat(fd, &st) != 0)
+            {
+                cout << "Cannot open file " << file_path << " for reading \n";
+                exit(1);
+            }
+
+            bytes = st.st_size;
+            if(bytes > 0)
+            {
+                void *mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapping == MAP_FAILED)
+                {
+                    cout << "Cannot map file " << file_path << " for reading \n";
+                    exit(1);
+                }
+                madvise(mapping, bytes, MADV_SEQUENTIAL);
+                data = (const char*)mapping;
+            }
+            close(fd);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Destructor
+         */
+        ~MappedFile()
+        {
+            if(data)
+            {
+                munmap((void*)data, bytes);
+            }
+        }
+    };
+
+    /**
+     * @brief Skip spaces and tabs, but not the end of the line
+     * @param p : Current character
+     * @param end : End of the file
+     * @return First character that is not skipped
+     */
+    static const char* skip_blanks(const char *p, const char *end)
+    {
+        while(p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Skip the rest of the line
+     * @param p : Current character
+     * @param end : End of the file
+     * @return First character of the next line, or the end of the file
+     */
+    static const char* next_line(const char *p, const char *end)
+    {
+        const char *line_end = (const char*)memchr(p, '\n', end - p);
+        return line_end ? line_end + 1 : end;
+    }
+
+    /**
+     * @brief Parse a number
+     * @param p : First character of the number
+     * @param end : End of the file
+     * @param value : Output, the number
+     * @param file_path : File path, for the error message
+     * @param line : Line number, for the error message
+     * @return First character after the number
+     */
+    template<class T>
+    static const char* parse_number(const char *p, const char *end, T &value, const char *file_path, size_t line)
+    {
+        //from_chars does not accept an explicit plus sign
+        if(p < end && *p == '+')
+        {
+            ++p;
+        }
+
+        auto result = from_chars(p, end, value);
+        if(result.ec != errc())
+        {
+            cout << "Cannot parse a number at line " << line << " of " << file_path << "!!!" << endl;
+            exit(1);
+        }
+        return result.ptr;
+    }
+
     /**
-     * @brief Read files with vectors
+     * @brief Read files with vectors, whose coordinates are parsed directly into a VectorStore that the points refer to
      * @param file_path : File path
      * @param dim : The dimension of vectors
+     * @param vector_store : Output, the coordinates of the dataset, which must outlive it
      * @param Dataset : Dataset
+     * @return Size of the file and time taken to read it
      */
-    static void read_vectors(const char *file_path, size_t &dim, vector<Point> &Dataset)
+    static LoadStats read_vectors(const char *file_path, size_t &dim, VectorStore &vector_store, vector<Point> &Dataset)
     {
-        ifstream fin;
-        fin.open(file_path,std::ios::in);
+        auto start = chrono::steady_clock::now();
 
-        if (!fin)
+        if(vector_store.size() != 0)
         {
-            cout << "Cannot open file " << file_path << " for reading \n";
+            cout << "The VectorStore of a dataset must be empty before reading it!!!" << endl;
             exit(1);
         }
 
-        char first_line[1024]={0};
-        fin.getline(first_line,sizeof(first_line));
-        stringstream first_line_stream(first_line);
-        int D_size;
-        first_line_stream >> D_size;
-        first_line_stream >> dim;
-
-        char line[1024]={0};
-        size_t id = 0;
-        while(fin.getline(line,sizeof(line)))
-        {               
-            Point p;
-            p.id = id;
-            ++id;
-            p.dimension = dim;
-            p.type = 0;
+        MappedFile file(file_path);
+        const char *p = file.data;
+        const char *end = file.data + file.bytes;
+
+        //The first line holds the number of vectors and their dimension
+        size_t line = 1;
+        size_t D_size;
+        p = parse_number(skip_blanks(p, end), end, D_size, file_path, line);
+        p = parse_number(skip_blanks(p, end), end, dim, file_path, line);
+        p = next_line(p, end);
+
+        vector_store.dimension = dim;
+        vector_store.reserve(D_size);
+
+        size_t n = 0;
+        while(p < end)
+        {
             //Process each line
-            stringstream line_stream(line);
-            double num;
-            while(line_stream >> num)
+            ++line;
+            size_t count = 0;
+            p = skip_blanks(p, end);
+            while(p < end && *p != '\n')
+            {
+                double num;
+                p = parse_number(p, end, num, file_path, line);
+                vector_store.add_coordinate(num);
+                ++count;
+                p = skip_blanks(p, end);
+            }
+            p = next_line(p, end);
+
+            if(count == 0)
+            {
+                //Empty line
+                continue;
+            }
+            if(count != dim)
             {
-                p.coordinates.push_back(num);
+                cout << "Line " << line << " of " << file_path << " has " << count << " coordinates instead of " << dim << "!!!" << endl;
+                exit(1);
             }
-            Dataset.push_back(p);
+            ++n;
+        }
+
+        //The points refer to the store, so they are created once it is complete
+        Dataset.reserve(Dataset.size() + n);
+        for(size_t id = 0; id < n; ++id)
+        {
+            Dataset.push_back(Point(id, vector_store, id));
         }
 
-        fin.close();
+        chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+        return LoadStats{file.bytes, runtime_seconds.count()};
     }
 
     /**
-     * @brief Read files with words
+     * @brief Path of the binary cache of a text file
+     * @param file_path : Path of the text file
+     * @return Path of the cache
+     */
+    static string vector_cache_path(const char *file_path)
+    {
+        return string(file_path) + ".bin";
+    }
+
+    /**
+     * @brief FNV-1a hash of the coordinates of the cache, mixed a word rather than a byte at a time
+     * @param data : Coordinates
+     * @param count : Number of coordinates
+     * @return Checksum
+     */
+    static uint64_t cache_checksum(const double *data, size_t count)
+    {
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for(size_t i = 0; i < count; ++i)
+        {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            h = (h ^ word)*0x100000001B3ULL;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Write the coordinates of a dataset into a binary cache, through a temporary file that is moved to the path once complete
+     * @param cache_path : Path of the cache
+     * @param vector_store : Coordinates of the dataset
+     * @return Whether the cache was written
+     */
+    static bool write_vector_cache(const string &cache_path, const VectorStore &vector_store)
+    {
+        size_t n = vector_store.size();
+        size_t dim = vector_store.dimension;
+
+        VectorCacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "OADSVEC", 8);
+        header.version = cache_version;
+        header.dtype = FLOAT64;
+        header.n = n;
+        header.dim = dim;
+        header.checksum = cache_checksum(vector_store.data(), n*dim);
+
+        string tmp_path = cache_path + ".tmp";
+        FILE *file = fopen(tmp_path.c_str(), "wb");
+        if(!file)
+        {
+            cout << "Cannot create the cache " << tmp_path << ", the text file will be parsed again next time" << endl;
+            return false;
+        }
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(vector_store.data(), sizeof(double), n*dim, file) == n*dim;
+        written = (fclose(file) == 0) && written;
+        if(!written || rename(tmp_path.c_str(), cache_path.c_str()) != 0)
+        {
+            cout << "Cannot write the cache " << cache_path << ", the text file will be parsed again next time" << endl;
+            remove(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Map a binary cache as the storage of a dataset, whose points then refer to the mapped coordinates without copying them.
+     * The header and the size of the file are checked, while the checksum, which reads every page, is only checked on request
+     * @param cache_path : Path of the cache
+     * @param dim : Output, the dimension of vectors
+     * @param vector_store : Output, the coordinates of the dataset, which must be empty and outlive it
+     * @param Dataset : Dataset
+     * @param verify_checksum : Whether to check the checksum of the coordinates
+     * @return Whether a valid cache was mapped, the store and the dataset being left untouched otherwise
+     */
+    static bool map_vector_cache(const string &cache_path, size_t &dim, VectorStore &vector_store, vector<Point> &Dataset, bool verify_checksum = false)
+    {
+        int fd = open(cache_path.c_str(), O_RDONLY);
+        if(fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(VectorCacheHeader))
+        {
+            close(fd);
+            return false;
+        }
+
+        size_t bytes = st.st_size;
+        void *mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(mapping == MAP_FAILED)
+        {
+            return false;
+        }
+
+        //The coordinates start right after the header, so they are as aligned as the mapping
+        const VectorCacheHeader *header = (const VectorCacheHeader*)mapping;
+        const double *data = (const double*)((const char*)mapping + sizeof(VectorCacheHeader));
+        if(memcmp(header->magic, "OADSVEC", 8) != 0 || header->version != cache_version || header->dtype != FLOAT64
+            || bytes != sizeof(VectorCacheHeader) + header->n*header->dim*sizeof(double)
+            || (verify_checksum && cache_checksum(data, header->n*header->dim) != header->checksum))
+        {
+            cout << "The cache " << cache_path << " is not valid, the text file is parsed instead" << endl;
+            munmap(mapping, bytes);
+            return false;
+        }
+
+        dim = header->dim;
+        vector_store.dimension = dim;
+        vector_store.adopt_mapping(mapping, bytes, data, header->n);
+        Dataset.reserve(Dataset.size() + header->n);
+        for(size_t id = 0; id < header->n; ++id)
+        {
+            Dataset.push_back(Point(id, vector_store, id));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read files with vectors through their binary cache: the cache is mapped when it is newer than the text file,
+     * otherwise the text file is parsed and the cache is written for the next runs
+     * @param file_path : File path of the text file
+     * @param dim : The dimension of vectors
+     * @param vector_store : Output, the coordinates of the dataset, which must outlive it
+     * @param Dataset : Dataset
+     * @param verify_checksum : Whether to check the checksum of a mapped cache, which reads all of it
+     * @return Size of the file read, the cache or the text file, and time taken to read it
+     */
+    static LoadStats read_vectors_cached(const char *file_path, size_t &dim, VectorStore &vector_store, vector<Point> &Dataset, bool verify_checksum = false)
+    {
+        auto start = chrono::steady_clock::now();
+
+        if(vector_store.size() != 0)
+        {
+            cout << "The VectorStore of a dataset must be empty before reading it!!!" << endl;
+            exit(1);
+        }
+
+        //The cache is used if the text file is missing or older
+        string cache_path = vector_cache_path(file_path);
+        struct stat text_stat, cache_stat;
+        bool has_cache = stat(cache_path.c_str(), &cache_stat) == 0;
+        bool has_text = stat(file_path, &text_stat) == 0;
+        bool fresh = has_cache && (!has_text
+            || cache_stat.st_mtim.tv_sec > text_stat.st_mtim.tv_sec
+            || (cache_stat.st_mtim.tv_sec == text_stat.st_mtim.tv_sec && cache_stat.st_mtim.tv_nsec > text_stat.st_mtim.tv_nsec));
+        if(fresh && map_vector_cache(cache_path, dim, vector_store, Dataset, verify_checksum))
+        {
+            chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+            return LoadStats{vector_store.mapping_bytes, runtime_seconds.count()};
+        }
+
+        LoadStats stats = read_vectors(file_path, dim, vector_store, Dataset);
+        write_vector_cache(cache_path, vector_store);
+        return stats;
+    }
+
+    /**
+     * @brief Read files with words, which are interned into a TokenStore that the points refer to
      * @param file_path : File path
+     * @param token_store : Output, the words of the dataset, which must outlive it
      * @param Dataset : Dataset
+     * @return Size of the file and time taken to read it
      */
-    static void read_words(const char *file_path, vector<Point> &Dataset)
+    static LoadStats read_words(const char *file_path, TokenStore &token_store, vector<Point> &Dataset)
     {
-        ifstream fin;
-        fin.open(file_path,std::ios::in);
+        auto start = chrono::steady_clock::now();
 
-        if (!fin)
+        if(token_store.size() != 0)
         {
-            cout << "Cannot open file " << file_path << " for reading \n";
+            cout << "The TokenStore of a dataset must be empty before reading it!!!" << endl;
             exit(1);
         }
 
-        char first_line[1024]={0};
-        fin.getline(first_line,sizeof(first_line));
-        stringstream first_line_stream(first_line);
-        int D_size;
-        first_line_stream >> D_size;
+        MappedFile file(file_path);
+        const char *p = file.data;
+        const char *end = file.data + file.bytes;
+
+        //The first line holds the number of texts
+        size_t line = 1;
+        size_t D_size;
+        p = parse_number(skip_blanks(p, end), end, D_size, file_path, line);
+        p = next_line(p, end);
 
-        char line[1024]={0};
-        size_t id = 0;
-        while(fin.getline(line,sizeof(line)))
+        vector<double> retweets;
+        retweets.reserve(D_size);
+        //The word being interned, whose storage is reused
+        string word;
+        while(p < end)
         {
-            Point p;
-            p.id = id;
-            ++id;
-            p.type = 1;
-            //Process each line
-            stringstream line_stream(line);
-            line_stream>>p.retweets;
-            string word;
-            int dim = 0;
-            while(line_stream >> word)
+            //Process each line, the retweets followed by the words
+            ++line;
+            p = skip_blanks(p, end);
+            if(p == end || *p == '\n')
+            {
+                //Empty line
+                p = next_line(p, end);
+                continue;
+            }
+
+            double r;
+            p = parse_number(p, end, r, file_path, line);
+            retweets.push_back(r);
+            p = skip_blanks(p, end);
+            while(p < end && *p != '\n')
             {
-                ++dim;
-                p.words.push_back(word);
+                const char *word_end = p;
+                while(word_end < end && !isspace((unsigned char)*word_end))
+                {
+                    ++word_end;
+                }
+                word.assign(p, word_end - p);
+                token_store.add_word(word);
+                p = skip_blanks(word_end, end);
             }
-            p.dimension = dim;
-            Dataset.push_back(p);
+            p = next_line(p, end);
+            token_store.end_text();
+        }
+
+        //The points refer to the CSR array, so they are created once it is complete
+        token_store.sort_words();
+        Dataset.reserve(Dataset.size() + retweets.size());
+        for(size_t id = 0; id < retweets.size(); ++id)
+        {
+            Dataset.push_back(Point(id, token_store, id, retweets[id]));
         }
 
-        fin.close();
+        chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+        return LoadStats{file.bytes, runtime_seconds.count()};
     }
 };
 #endif
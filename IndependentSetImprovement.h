@@ -12,16 +12,25 @@
 
 using namespace std;
 
-class IndependentSetImprovement : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class IndependentSetImprovementT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
+
+    //Positions in the solution set in descending order of fdelta
+    vector<size_t> order;
+
+    //Marginal gain of each point of the solution set when it was added, indexed by positions in the solution set
+    vector<double> fdeltas;
 
     /**
      * @brief Constructor
      * @param k: Cardinality constraint
      * @param f: Submodular function
      */
-    IndependentSetImprovement(size_t k, SubmodularFunction &f) : SubsetSelectionAlgorithm(k, f)
+    IndependentSetImprovementT(size_t k, F &f) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f))
     {
     
     }
@@ -45,29 +54,31 @@ public:
      */
     void next(const Point &cur_point)
     {
-        Point t(cur_point);
-        double fdelta = f.peek(solution, t, solution.size()) - fval;
-        t.fdelta = fdelta;
+        SubmodularFunction::Evaluation eval;
+        double fdelta = f.peek(solution, cur_point, solution.size(), eval) - fval;
 
         if (solution.size() < k)
         {
             //Add to the solution set directly 
-            f.update(solution, t, solution.size());   
+            order.push_back(solution.size());
+            fdeltas.push_back(fdelta);
+            f.commit(solution, cur_point, solution.size(), eval);   
             fval = f.operator()(solution);
 
             //Descend order
-            f.sort_descend_fdelta(solution);
+            f.sort_descend_fdelta(fdeltas, order);
         }
         else
         {
-            if(fdelta > 2*solution.back().fdelta)
+            if(fdelta > 2*fdeltas[order.back()])
             {
-                //Replace the point at the end
-                f.update(solution, t, solution.size()-1); 
+                //Replace the point at the end of the order
+                fdeltas[order.back()] = fdelta;
+                f.commit(solution, cur_point, order.back(), eval); 
                 fval = f.operator()(solution);
 
                 //Descend order
-                f.sort_descend_fdelta(solution);
+                f.sort_descend_fdelta(fdeltas, order);
             }
         }
     }
@@ -75,7 +86,9 @@ public:
     /**
      * @brief Destructor
      */
-    ~IndependentSetImprovement() {}
+    ~IndependentSetImprovementT() {}
 };
 
+typedef IndependentSetImprovementT<> IndependentSetImprovement;
+
 #endif
\ No newline at end of file
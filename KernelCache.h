@@ -0,0 +1,325 @@
+#ifndef KERNELCACHE_H
+#define KERNELCACHE_H
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+/**
+ * @brief Bounded cache of kernel values keyed by pairs of point ids, shared by the clones of a submodular function.
+ * The pairs are spread over shards by their larger id, each one a direct-mapped table with its own lock, so that clones running in
+ * different threads rarely wait for each other. A pair that maps to an occupied slot replaces the pair in it.
+ * The kernel values between a point and the solution set are looked up and stored a row at a time: the pairs of the row are grouped
+ * by shard and each shard is locked once, which is a single lock for the row of a point that arrived after the solution set.
+ * The ids must identify the points of a single dataset, and the kernel parameters must be the same for all users.
+ */
+
+class KernelCache
+{
+public:
+
+    //Number of shards, a power of two
+    static const size_t shard_count = 64;
+
+    //A cached kernel value, i <= j, i is empty_id for an empty slot
+    struct Entry
+    {
+        size_t i;
+        size_t j;
+        double value;
+    };
+
+    //A direct-mapped table with its own lock
+    struct Shard
+    {
+        mutex lock;
+        vector<Entry> slots;
+    };
+
+    //Workspace of the row operations of one user of the cache: the shard and the slot of each pair of a row,
+    //the pairs grouped by shard, and the shard of each group with where it starts in order
+    struct RowWorkspace
+    {
+        vector<size_t> shard;
+        vector<size_t> slot;
+        vector<size_t> order;
+        vector<size_t> group_shard;
+        vector<size_t> group_start;
+        size_t count[shard_count];
+
+        /**
+         * @brief Make room for rows of a given length
+         * @param n : Length of the rows
+         */
+        void reserve(size_t n)
+        {
+            shard.reserve(n);
+            slot.reserve(n);
+            order.reserve(n);
+            group_shard.reserve(shard_count);
+            group_start.reserve(shard_count+1);
+        }
+    };
+
+    //Id that marks an empty slot
+    static const size_t empty_id = SIZE_MAX;
+
+    //Shards
+    Shard shards[shard_count];
+    //Number of slots of each shard
+    size_t slots_per_shard;
+
+    //Counters of the lookups
+    atomic<uint64_t> hits;
+    atomic<uint64_t> misses;
+
+    /**
+     * @brief Constructor
+     * @param capacity : Maximum number of cached kernel values
+     */
+    KernelCache(size_t capacity)
+    {
+        slots_per_shard = max<size_t>(1, capacity/shard_count);
+        for(auto &shard : shards)
+        {
+            shard.slots.assign(slots_per_shard, Entry{empty_id, empty_id, 0});
+        }
+        hits = 0;
+        misses = 0;
+    }
+
+    /**
+     * @brief Hash of a pair of ids, which does not depend on their order
+     * @param i : Smaller id
+     * @param j : Larger id
+     * @return Hash
+     */
+    static uint64_t hash(size_t i, size_t j)
+    {
+        uint64_t h = i*0x9E3779B97F4A7C15ULL ^ (j + 0x632BE59BD9B4E019ULL + (i << 6) + (i >> 2));
+        h ^= h >> 31;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 29;
+        return h;
+    }
+
+    /**
+     * @brief Shard of a pair of ids, which only depends on the larger one
+     * @param j : Larger id
+     * @return Index of the shard
+     */
+    static size_t shard_of(size_t j)
+    {
+        return hash(j, j) & (shard_count-1);
+    }
+
+    /**
+     * @brief Slot of a pair of ids in its shard
+     * @param i : Smaller id
+     * @param j : Larger id
+     * @return Index of the slot
+     */
+    size_t slot_of(size_t i, size_t j) const
+    {
+        return hash(i, j) % slots_per_shard;
+    }
+
+    /**
+     * @brief Look up the kernel value of a pair of points
+     * @param i : Id of a point
+     * @param j : Id of the other point
+     * @param value : Output, the kernel value if it is cached
+     * @return Whether the kernel value is cached
+     */
+    bool lookup(size_t i, size_t j, double &value)
+    {
+        if(i > j)
+        {
+            swap(i, j);
+        }
+        Shard &shard = shards[shard_of(j)];
+
+        lock_guard<mutex> guard(shard.lock);
+        const Entry &entry = shard.slots[slot_of(i, j)];
+        if(entry.i == i && entry.j == j)
+        {
+            value = entry.value;
+            hits.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+        misses.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Store the kernel value of a pair of points
+     * @param i : Id of a point
+     * @param j : Id of the other point
+     * @param value : Kernel value
+     */
+    void insert(size_t i, size_t j, double value)
+    {
+        if(i > j)
+        {
+            swap(i, j);
+        }
+        Shard &shard = shards[shard_of(j)];
+
+        lock_guard<mutex> guard(shard.lock);
+        shard.slots[slot_of(i, j)] = Entry{i, j, value};
+    }
+
+    /**
+     * @brief Group the pairs between a point and n other points by shard into the workspace, with a counting sort
+     * unless they all fall in the same shard, as they do when the point has the largest id
+     * @param id : Id of the point
+     * @param n : Number of other points
+     * @param other : other(r) is the id of the r-th other point
+     * @param w : Workspace
+     */
+    template<class Ids>
+    void group(size_t id, size_t n, const Ids &other, RowWorkspace &w) const
+    {
+        w.shard.resize(n);
+        w.slot.resize(n);
+        w.order.resize(n);
+        w.group_shard.clear();
+        w.group_start.clear();
+        if(n == 0)
+        {
+            w.group_start.push_back(0);
+            return;
+        }
+
+        bool one_shard = true;
+        for(size_t r = 0; r < n; ++r)
+        {
+            size_t i = min<size_t>(id, other(r)), j = max<size_t>(id, other(r));
+            w.shard[r] = shard_of(j);
+            w.slot[r] = slot_of(i, j);
+            one_shard = one_shard && w.shard[r] == w.shard[0];
+        }
+        if(one_shard)
+        {
+            iota(w.order.begin(), w.order.end(), 0);
+            w.group_shard.push_back(w.shard[0]);
+            w.group_start.push_back(0);
+            w.group_start.push_back(n);
+            return;
+        }
+
+        fill(w.count, w.count + shard_count, 0);
+        for(size_t r = 0; r < n; ++r)
+        {
+            ++w.count[w.shard[r]];
+        }
+        //count[s] becomes the position of the next pair of shard s in order
+        size_t start = 0;
+        for(size_t s = 0; s < shard_count; ++s)
+        {
+            if(w.count[s] > 0)
+            {
+                w.group_shard.push_back(s);
+                w.group_start.push_back(start);
+            }
+            size_t c = w.count[s];
+            w.count[s] = start;
+            start += c;
+        }
+        w.group_start.push_back(n);
+        for(size_t r = 0; r < n; ++r)
+        {
+            w.order[w.count[w.shard[r]]++] = r;
+        }
+    }
+
+    /**
+     * @brief Look up the kernel values between a point and n other points, locking each shard once
+     * @param id : Id of the point
+     * @param n : Number of other points
+     * @param other : other(r) is the id of the r-th other point
+     * @param values : Output, values[r] is the kernel value with the r-th other point if it is cached
+     * @param missing : Output, the other points whose kernel values are not cached, in no particular order
+     * @param w : Workspace
+     */
+    template<class Ids>
+    void lookup_row(size_t id, size_t n, const Ids &other, double *values, vector<size_t> &missing, RowWorkspace &w)
+    {
+        missing.clear();
+        group(id, n, other, w);
+        for(size_t g = 0; g < w.group_shard.size(); ++g)
+        {
+            Shard &shard = shards[w.group_shard[g]];
+            lock_guard<mutex> guard(shard.lock);
+            for(size_t q = w.group_start[g]; q < w.group_start[g+1]; ++q)
+            {
+                size_t r = w.order[q];
+                size_t i = min<size_t>(id, other(r)), j = max<size_t>(id, other(r));
+                const Entry &entry = shard.slots[w.slot[r]];
+                if(entry.i == i && entry.j == j)
+                {
+                    values[r] = entry.value;
+                }
+                else
+                {
+                    missing.push_back(r);
+                }
+            }
+        }
+        hits.fetch_add(n - missing.size(), memory_order_relaxed);
+        misses.fetch_add(missing.size(), memory_order_relaxed);
+    }
+
+    /**
+     * @brief Store the kernel values between a point and n other points, locking each shard once
+     * @param id : Id of the point
+     * @param n : Number of other points
+     * @param other : other(r) is the id of the r-th other point
+     * @param value : value(r) is the kernel value with the r-th other point
+     * @param w : Workspace
+     */
+    template<class Ids, class Values>
+    void insert_row(size_t id, size_t n, const Ids &other, const Values &value, RowWorkspace &w)
+    {
+        group(id, n, other, w);
+        for(size_t g = 0; g < w.group_shard.size(); ++g)
+        {
+            Shard &shard = shards[w.group_shard[g]];
+            lock_guard<mutex> guard(shard.lock);
+            for(size_t q = w.group_start[g]; q < w.group_start[g+1]; ++q)
+            {
+                size_t r = w.order[q];
+                size_t i = min<size_t>(id, other(r)), j = max<size_t>(id, other(r));
+                shard.slots[w.slot[r]] = Entry{i, j, value(r)};
+            }
+        }
+    }
+
+    /**
+     * @brief Fraction of the lookups that were hits
+     * @return Hit rate, 0 before any lookup
+     */
+    double hit_rate() const
+    {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0 : double(hits)/total;
+    }
+
+    /**
+     * @brief Memory used by the tables
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        return shard_count*slots_per_shard*sizeof(Entry);
+    }
+};
+
+#endif // KERNELCACHE_H
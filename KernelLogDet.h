@@ -0,0 +1,871 @@
+#ifndef KERNELLOGDET_H
+#define KERNELLOGDET_H
+
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <functional>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <iostream>
+#include <Eigen/Dense>
+#include <Eigen/Core>
+
+#include "SubmodularFunction.h"
+#include "CholeskyFactor.h"
+#include "KernelRow.h"
+#include "KernelCache.h"
+#include "GramMatrix.h"
+#include "FeatureVecSubFunc.h"
+#include "Point.h"
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Gaussian kernel a*exp(-r^2/(2*l^2)) with l = 1/(2*sqrt(dimension)), the value of a set being log(det(M))/2
+ */
+struct GaussianKernel
+{
+    //Expression of KernelRow that computes rows of this kernel
+    static constexpr KernelRow::Kernel expression = KernelRow::Gaussian;
+    //The value of a set is scale*log(det(M))
+    static constexpr double scale = 0.5;
+
+    //Parameters
+    double l;
+    double a;
+
+    /**
+     * @brief Constructor
+     * @param dimension : Vector dimension
+     */
+    GaussianKernel(int dimension)
+    {
+        if(dimension <= 0)
+        {
+            cout << "The Gaussian kernel needs the vector dimension!!!" << endl;
+            exit(1);
+        }
+
+        l = 1/(2*sqrt(dimension));
+        a = 1;
+    }
+
+    /**
+     * @brief Rate of the exponent, as passed to KernelRow
+     * @return gamma in a*exp(-gamma*r^2)
+     */
+    double gamma() const
+    {
+        return 1/(2*l*l);
+    }
+};
+
+/**
+ * @brief Laplacian kernel a*exp(-r), the value of a set being log(det(M))
+ */
+struct LaplacianKernel
+{
+    //Expression of KernelRow that computes rows of this kernel
+    static constexpr KernelRow::Kernel expression = KernelRow::Laplacian;
+    //The value of a set is scale*log(det(M))
+    static constexpr double scale = 1;
+
+    //Parameters
+    double a;
+
+    /**
+     * @brief Constructor
+     * @param dimension : Vector dimension, which the kernel does not depend on
+     */
+    LaplacianKernel(int /*dimension*/)
+    {
+        a = 10;
+    }
+
+    /**
+     * @brief Rate of the exponent, as passed to KernelRow
+     * @return gamma in a*exp(-gamma*r)
+     */
+    double gamma() const
+    {
+        return 1;
+    }
+};
+
+/**
+ * @brief The log-determinant function scale*log(det(M)) of a kernel matrix M = I + K, with the diagonal 1+a, maintained by an incremental Cholesky factor.
+ * GauVecSubFunc and LapVecSubFunc are this function with GaussianKernel and LaplacianKernel.
+ * @tparam Kernel : Kernel functor, which provides its expression in KernelRow, the scale of the value, a and gamma()
+ * @tparam Dim : Vector dimension known at compile time, or Dynamic
+ * @tparam MaxK : Maximum size of the solution set known at compile time, so that the storage is fixed-size, or Dynamic
+ */
+
+template<class Kernel, int Dim = Dynamic, int MaxK = Dynamic>
+class KernelLogDet final : public SubmodularFunction
+{  
+public:
+
+    //Capacity of the fixed-size storage, one more than MaxK for the evaluated point
+    static const int Capacity = (MaxK == Dynamic) ? Dynamic : MaxK+1;
+
+    //Kernel and its parameters
+    Kernel kernel;
+    //Parameter a of the kernel, the diagonal of M being 1+a
+    double a;
+
+    //Data stored for acceleration to avoid repeated calculations
+    //The matrix composed of the current solution set, indexed by positions in the solution set
+    //Positions never move, so only the leading block of the size of the solution set is valid
+    //It is kept in double, since a replacement changes the factor by the difference between the new and the old column of M
+    Matrix<double,Dynamic,Dynamic,ColMajor,Capacity,Capacity> M;
+    //Cholesky factor of M
+    CholeskyFactor<Capacity> factor;
+    //Coordinates of the solution set, one point per row at its position
+    Matrix<double,Dynamic,Dim,ColMajor,Capacity,Dim> X_S;
+    //Value of the current solution set
+    double fval;
+
+    //Intermediate results of the last evaluation, which commit() installs without recomputation
+    //They are preallocated by reserve() and only the leading entries are valid
+    //Kernel values between the evaluated point and the solution set
+    Matrix<double,Dynamic,1,ColMajor,Capacity,1> pending_b;
+    //Append: solution of L*y = pending_b and the Schur complement
+    Matrix<double,Dynamic,1,ColMajor,Capacity,1> pending_y;
+    double pending_schur;
+    //Replace: change of the column of M
+    Matrix<double,Dynamic,1,ColMajor,Capacity,1> pending_u;
+    //Kernel block of peek_many() between the solution set and a block of at most many_block_size candidates, one column per candidate
+    static const int many_block_size = 256;
+    Matrix<double,Dynamic,Dynamic> many_B;
+    //Kernel values between a point and the solution set, computed by gain_upper_bound() without touching the pending evaluation
+    Matrix<double,Dynamic,1,ColMajor,Capacity,1> bound_b;
+    //Ticket and id of the point of bound_b, which prepare() reuses if no other evaluation has been issued since
+    size_t bound_ticket;
+    size_t bound_id;
+    //Ticket of the pending evaluation, 0 if it has been consumed or invalidated
+    size_t pending_ticket;
+    //Last issued ticket
+    size_t last_ticket;
+
+    //A, only stored for FreeDisposal: coordinates of its points, one point per row in the order of arrival, and the Cholesky factor of its matrix
+    Matrix<double,Dynamic,Dim> X_A;
+    CholeskyFactor<> factor_A;
+    //Kernel values between a point and A, the solution of L_A*y = b_A and the Schur complement
+    Matrix<double,Dynamic,1> b_A;
+    Matrix<double,Dynamic,1> y_A;
+    double schur_A;
+    //Id of the point for which y_A and schur_A are valid, so that update() reuses the work of peek_delta_A()
+    size_t pending_A_id;
+    //Number of points of A kept exactly, 0 for no limit, beyond which A is summarized by A_sketch with A_sketch_features random Fourier features
+    size_t A_limit;
+    int A_sketch_features;
+    optional<FeatureVecSubFunc> A_sketch;
+
+    //Workspaces of peek_delta_A_cap_S() and delta_A_cap_S_all(): positions of the solution set in the order of arrival, M in that order and its Cholesky factor
+    vector<size_t> by_id;
+    Matrix<double,Dynamic,Dynamic,ColMajor,Capacity,Capacity> M_by_id;
+    CholeskyFactor<Capacity> factor_by_id;
+
+    //Kernel values shared with the clones of this function, not used if null
+    shared_ptr<KernelCache> cache;
+    //Workspaces of kernel_row(): positions of the solution set whose kernel values are not cached, their coordinates gathered one point per row, and their kernel values,
+    //and the pairs of the row grouped by the shards of the cache
+    vector<size_t> missing;
+    Matrix<double,Dynamic,Dim,ColMajor,Capacity,Dim> X_missing;
+    Matrix<double,Dynamic,1,ColMajor,Capacity,1> b_missing;
+    KernelCache::RowWorkspace cache_row;
+    //Precomputed kernel values of all pairs of points of the dataset, used instead of the cache if not null
+    shared_ptr<GramMatrix> gram;
+
+    /**
+     * @brief Constructor
+     * @param dimension : Vector dimension, which may be omitted if the kernel does not depend on it
+     */
+    KernelLogDet(int dimension = 0) : kernel(dimension)
+    {
+        if(Dim != Dynamic && dimension != 0 && dimension != Dim)
+        {
+            cout << "The dimension " << dimension << " does not match the compiled dimension " << Dim << "!!!" << endl;
+            exit(1);
+        }
+
+        a = kernel.a;
+        fval = 0;
+        pending_ticket = 0;
+        last_ticket = 0;
+        bound_ticket = 0;
+        bound_id = SIZE_MAX;
+        fval_A = 0;
+        pending_A_id = SIZE_MAX;
+        A_limit = 0;
+        A_sketch_features = 256;
+        store_A = false;
+        query = 0;
+    }
+
+    /**
+     * @brief Calculate the value of the solution set
+     * @param cur_solution : Current solution set
+     * @return Value of the solution set
+     */
+    double operator()(const vector<Point> &cur_solution)
+    {
+        if(cur_solution.empty())
+        {
+            return 0;
+        }
+ 
+        return fval;
+    }
+
+    /**
+     * @brief Preallocate the workspaces so that peek() and update() do not allocate
+     * @param capacity : Maximum size of the solution set plus one
+     */
+    void reserve(size_t capacity)
+    {
+        if(Capacity != Dynamic)
+        {
+            if(capacity > Capacity)
+            {
+                cout << "The capacity " << capacity << " exceeds the compiled capacity " << Capacity << "!!!" << endl;
+                exit(1);
+            }
+            //The storage is fixed-size, so take all of it at once
+            capacity = Capacity;
+        }
+
+        if(M.rows() >= (Index)capacity)
+        {
+            return;
+        }
+
+        M.conservativeResize(capacity,capacity);
+        X_S.conservativeResize(capacity,X_S.cols());
+        pending_b.resize(capacity);
+        pending_y.resize(capacity);
+        pending_u.resize(capacity);
+        bound_b.resize(capacity);
+        many_B.resize(capacity, many_block_size);
+        factor.reserve(capacity);
+        by_id.reserve(capacity);
+        missing.reserve(capacity);
+        cache_row.reserve(capacity);
+        X_missing.resize(capacity,X_S.cols());
+        b_missing.resize(capacity);
+        M_by_id.resize(capacity,capacity);
+        factor_by_id.reserve(capacity);
+    }
+
+    /**
+     * @brief Calculate the value after adding a point to the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @param position : Position for the point to be added
+     * @return Value after adding point
+     */
+    double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        Evaluation eval;
+        return peek(cur_solution, cur_point, position, eval);
+    }
+
+    /**
+     * @brief Calculate the value after adding a point to the solution set and keep the intermediate results for commit()
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @param position : Position for the point to be added
+     * @param eval : Output, handle of this evaluation
+     * @return Value after adding point
+     */
+    double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position, Evaluation &eval)
+    {
+        ++query;
+
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        prepare(cur_solution, cur_point, position);
+
+        if(position == cur_solution.size())
+        {          
+            //Append
+            //The determinant of the expanded matrix is det(M) * (1+a - b^T * M^{-1} * b)
+            eval.value = Kernel::scale*(factor.log_det + log(pending_schur));
+        }
+        else
+        {
+            //Replace
+            //Rank-2 change of M, scored with the matrix determinant lemma
+            eval.value = Kernel::scale*(factor.log_det + log(factor.replace_ratio(position, pending_u.head(cur_solution.size()))));
+        }
+
+        eval.id = cur_point.id;
+        eval.position = position;
+        eval.ticket = pending_ticket;
+
+        return eval.value;
+    }
+
+    /**
+     * @brief Upper bound of the marginal gain of appending a point, from its kernel value with the nearest point of the solution set
+     * Since b^T * M^{-1} * b >= b_i^2/M_ii for every i, the Schur complement is at most 1+a - max_i b_i^2/(1+a)
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Upper bound of the marginal gain
+     */
+    double gain_upper_bound(const vector<Point> &cur_solution, const Point &cur_point)
+    {
+        int S_size = cur_solution.size();
+        if(S_size == 0)
+        {
+            return Kernel::scale*log(1+a);
+        }
+        if(S_size > bound_b.size())
+        {
+            //Only reached when reserve() was not called with enough capacity
+            reserve(Capacity == Dynamic ? 2*S_size : S_size);
+        }
+
+        NoMallocScope no_malloc;
+
+        //Kernel values between the point and the current solution set, without the triangular solve of peek()
+        auto b = bound_b.head(S_size);
+        kernel_row(cur_solution, cur_point, b);
+        double b_max = b.maxCoeff();
+        bound_ticket = ++last_ticket;
+        bound_id = cur_point.id;
+
+        return Kernel::scale*log(1+a - b_max*b_max/(1+a));
+    }
+
+    /**
+     * @brief Calculate the marginal gains of appending each of a block of candidates to the solution set
+     * @param cur_solution : Current solution set
+     * @param candidates : Points to be evaluated, each one separately
+     * @param fdeltas : Output, fdeltas[j] is the marginal gain of candidates[j]
+     */
+    void peek_many(const vector<Point> &cur_solution, const vector<const Point*> &candidates, vector<double> &fdeltas)
+    {
+        query += candidates.size();
+
+        fdeltas.resize(candidates.size());
+
+        int S_size = cur_solution.size();
+        if(S_size == 0)
+        {
+            fill(fdeltas.begin(), fdeltas.end(), Kernel::scale*log(1+a));
+            return;
+        }
+
+        if(S_size > many_B.rows())
+        {
+            //Only reached when reserve() was not called with enough capacity
+            reserve(Capacity == Dynamic ? 2*S_size : S_size);
+        }
+
+        NoMallocScope no_malloc;
+
+        //Evaluate candidates in blocks to bound the memory of the kernel block
+        for(size_t start = 0; start < candidates.size(); start += many_block_size)
+        {
+            int C_size = min<size_t>(many_block_size, candidates.size()-start);
+
+            //Kernel block between the solution set and the candidates, one column per candidate with the same values as peek()
+            auto B = many_B.topLeftCorner(S_size,C_size);
+            for(int j = 0; j < C_size; ++j)
+            {
+                kernel_row(cur_solution, *candidates[start+j], B.col(j));
+            }
+
+            //Schur complements of all candidates from one triangular solve
+            factor.solve_lower(B);
+            for(int j = 0; j < C_size; ++j)
+            {
+                fdeltas[start+j] = Kernel::scale*log(1+a - B.col(j).squaredNorm());
+            }
+        }
+    }
+
+    /**
+     * @brief Update the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void update(vector<Point> &cur_solution, const Point &cur_point, size_t position) 
+    {
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        prepare(cur_solution, cur_point, position);
+        install(cur_solution, cur_point, position);
+    }
+
+    /**
+     * @brief Update the solution set with the intermediate results kept by peek()
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     * @param eval : Handle returned by peek() for cur_point
+     */
+    void commit(vector<Point> &cur_solution, const Point &cur_point, size_t position, const Evaluation &eval)
+    {
+        //The kernel values of an append evaluation also serve a replacement at any position
+        bool reusable = eval.ticket != 0 && eval.ticket == pending_ticket && eval.id == cur_point.id
+            && (eval.position == position || (eval.position == cur_solution.size() && position < cur_solution.size()));
+
+        if(!reusable)
+        {
+            update(cur_solution, cur_point, position);
+            return;
+        }
+
+        install(cur_solution, cur_point, position);
+    }
+
+    /**
+     * @brief Read the kernel values from the Gram matrix file of a dataset, which is built if it does not exist yet
+     * The ids of the points passed to this function and its clones must be their positions in the dataset
+     * @param Dataset : Dataset
+     * @param directory : Directory of the Gram matrix files
+     */
+    void use_gram_matrix(const vector<Point> &Dataset, const string &directory)
+    {
+        gram = make_shared<GramMatrix>(Dataset, Kernel::expression, a, kernel.gamma(), directory);
+    }
+
+    /**
+     * @brief Compute the kernel values between a point and the solution set in one pass, or read them from the Gram matrix,
+     * or take those that are cached and compute only the others
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point whose kernel values are computed
+     * @param b : Output, b(i) is the kernel value between the point and the point at position i
+     */
+    void kernel_row(const vector<Point> &cur_solution, const Point &cur_point, Ref<Matrix<double,Dynamic,1>> b)
+    {
+        size_t S_size = b.size();
+        if(gram)
+        {
+            for(size_t i = 0; i < S_size; ++i)
+            {
+                b(i) = gram->at(cur_point.id, cur_solution[i].id);
+            }
+            return;
+        }
+        if(!cache)
+        {
+            KernelRow::compute<Dim>(Kernel::expression, a, kernel.gamma(), X_S.data(), X_S.rows(), S_size, cur_point.coordinates, cur_point.dimension, b.data());
+            return;
+        }
+
+        //Every cached value is used, so only the others are computed, and the row is looked up and stored locking each shard once
+        auto other = [&](size_t i)->size_t{ return cur_solution[i].id; };
+        cache->lookup_row(cur_point.id, S_size, other, b.data(), missing, cache_row);
+        if(missing.empty())
+        {
+            return;
+        }
+
+        if(missing.size() == S_size)
+        {
+            //Nothing is cached, so the whole row is computed in one vectorized pass
+            KernelRow::compute<Dim>(Kernel::expression, a, kernel.gamma(), X_S.data(), X_S.rows(), S_size, cur_point.coordinates, cur_point.dimension, b.data());
+        }
+        else
+        {
+            //The points whose values are missing are gathered and computed in one vectorized pass,
+            //which gives the same values as the whole row since KernelRow does not depend on the position of a point
+            size_t m = missing.size();
+            for(size_t j = 0; j < m; ++j)
+            {
+                X_missing.row(j) = X_S.row(missing[j]);
+            }
+            KernelRow::compute<Dim>(Kernel::expression, a, kernel.gamma(), X_missing.data(), X_missing.rows(), m, cur_point.coordinates, cur_point.dimension, b_missing.data());
+            for(size_t j = 0; j < m; ++j)
+            {
+                b(missing[j]) = b_missing(j);
+            }
+        }
+
+        cache->insert_row(cur_point.id, missing.size(), [&](size_t j)->size_t{ return cur_solution[missing[j]].id; },
+            [&](size_t j)->double{ return b(missing[j]); }, cache_row);
+    }
+
+    /**
+     * @brief Compute the kernel values of a point and the data needed to add it to M, and keep them as the pending evaluation
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void prepare(const vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        Index S_size = cur_solution.size();
+        //The position as an Eigen index, to compare it with the size of the solution set
+        Index pos = position;
+        if(S_size >= pending_b.size())
+        {
+            //Only reached when reserve() was not called with enough capacity
+            reserve(Capacity == Dynamic ? 2*(S_size+1) : S_size+1);
+        }
+        if(X_S.cols() != (Index)cur_point.dimension)
+        {
+            //Only reached for the first point, when the dimension becomes known
+            X_S.conservativeResize(X_S.rows(),cur_point.dimension);
+            X_missing.resize(X_missing.rows(),cur_point.dimension);
+        }
+
+        NoMallocScope no_malloc;
+
+        //Kernel values between the point and the current solution set, all in one pass,
+        //unless gain_upper_bound() has just computed them
+        auto b = pending_b.head(S_size);
+        if(bound_ticket != 0 && bound_ticket == last_ticket && bound_id == cur_point.id)
+        {
+            b = bound_b.head(S_size);
+        }
+        else
+        {
+            kernel_row(cur_solution, cur_point, b);
+        }
+        if(pos < S_size)
+        {
+            b(pos) = 1+a;
+        }
+
+        if(pos == S_size)
+        {
+            //Append
+            pending_schur = factor.schur_complement(b, 1+a, pending_y.head(S_size));
+        }
+        else
+        {
+            //Replace
+            //Change of the column of M at position
+            pending_u.head(S_size) = b - M.col(position).head(S_size);
+            pending_u(position) = 0;
+        }
+
+        pending_ticket = ++last_ticket;
+    }
+
+    /**
+     * @brief Add a point to the solution set using the pending evaluation
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void install(vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        if(position == cur_solution.size())
+        {
+            //Append
+
+            //Update the solution set
+            cur_solution.push_back(cur_point);        
+
+            //Update the factor of M
+            NoMallocScope no_malloc;
+            factor.append(pending_y.head(position), pending_schur);
+
+            //Update the coordinates of the solution set
+            X_S.row(position) = Map<const Matrix<double,1,Dim>>(cur_point.coordinates, cur_point.dimension);
+
+            //Update M, whose storage already has room for the new row and column
+            M(position,position) = 1+a;
+            for(size_t i = 0; i < position; ++i)
+            {                  
+                M(i,position) = pending_b(i);
+                M(position,i) = M(i,position);  
+            }
+        }
+        else
+        {
+            //Replace
+
+            //Update the solution set
+            cur_solution[position] = cur_point;  
+
+            //Change of the column of M at position
+            NoMallocScope no_malloc;
+            int S_size = cur_solution.size();
+            pending_u.head(S_size) = pending_b.head(S_size) - M.col(position).head(S_size);
+            pending_u(position) = 0;
+
+            //Update M
+            for(size_t i = 0; i < cur_solution.size(); ++i)
+            {   
+                if(i != position)
+                {
+                    M(i,position) = pending_b(i);
+                    M(position,i) = M(i,position);  
+                }
+            }
+
+            //Update the factor of M in place
+            factor.replace(position, pending_u.head(S_size));
+
+            //Update the coordinates of the solution set
+            X_S.row(position) = Map<const Matrix<double,1,Dim>>(cur_point.coordinates, cur_point.dimension);
+        }
+
+        //The pending evaluation has been consumed and the kernel values of the bound are stale
+        pending_ticket = 0;
+        bound_ticket = 0;
+
+        //Update fval
+        fval = Kernel::scale*factor.log_det;
+
+        if(store_A)
+        {
+            add_to_A(cur_point);
+        }
+    }
+
+    /**
+     * @brief Create a new submodular function
+     * @return Reference to the new submodular function
+     */
+    SubmodularFunction& new_object()
+    {
+        KernelLogDet *f = new KernelLogDet(*this);
+        return *f;
+    }
+
+    /**
+     * @brief Calculate the delta_value after adding a point to A
+     * @param cur_point : Point that is added to the current solution set
+     * @return The delta_value after adding the point
+     */
+    double peek_delta_A(const Point &cur_point)
+    {
+        ++query;
+
+        if(!store_A)
+        {
+            cout << "Did not store A!!! \n";
+            exit(1);
+        }
+
+        if(A_sketch)
+        {
+            return A_sketch->peek_delta_A(cur_point);
+        }
+
+        //The determinant of the expanded matrix is det(M_A) * (1+a - b^T * M_A^{-1} * b)
+        prepare_A(cur_point);
+        return Kernel::scale*log(schur_A);
+    }
+
+    /**
+     * @brief Compute the kernel values between a point and A and its Schur complement, and keep them for add_to_A()
+     * @param cur_point : Point that is added to A
+     */
+    void prepare_A(const Point &cur_point)
+    {
+        size_t A_size = factor_A.n;
+        if(X_A.rows() <= (Index)A_size)
+        {
+            //Grow geometrically so that appending is amortized
+            size_t capacity = max<size_t>(16, 2*(A_size+1));
+            X_A.conservativeResize(capacity, cur_point.dimension);
+            b_A.resize(capacity);
+            y_A.resize(capacity);
+            factor_A.reserve(capacity);
+        }
+
+        KernelRow::compute<Dim>(Kernel::expression, a, kernel.gamma(), X_A.data(), X_A.rows(), A_size, cur_point.coordinates, cur_point.dimension, b_A.data());
+        schur_A = factor_A.schur_complement(b_A.head(A_size), 1+a, y_A.head(A_size));
+        pending_A_id = cur_point.id;
+    }
+
+    /**
+     * @brief Add a point to A, appending a row to its Cholesky factor, or to its sketch beyond A_limit points
+     * @param cur_point : Point that is added to A
+     */
+    void add_to_A(const Point &cur_point)
+    {
+        if(!A_sketch && A_limit > 0 && (size_t)factor_A.n >= A_limit)
+        {
+            start_A_sketch(cur_point.dimension);
+        }
+        if(A_sketch)
+        {
+            //The value of A is carried on with the gains measured by the sketch
+            fval_A += A_sketch->add_to_A(cur_point);
+            return;
+        }
+
+        if(pending_A_id != cur_point.id)
+        {
+            prepare_A(cur_point);
+        }
+
+        size_t A_size = factor_A.n;
+        X_A.row(A_size) = Map<const Matrix<double,1,Dim>>(cur_point.coordinates, cur_point.dimension);
+        factor_A.append(y_A.head(A_size), schur_A);
+        pending_A_id = SIZE_MAX;
+
+        //Update fval_A
+        fval_A = Kernel::scale*factor_A.log_det;
+    }
+
+    /**
+     * @brief Summarize A by random Fourier features from now on, and release the exact storage of A
+     * @param dimension : Vector dimension
+     */
+    void start_A_sketch(int dimension)
+    {
+        //The sketch has the parameters of this kernel and only tracks A
+        A_sketch.emplace(Kernel::expression, a, kernel.gamma(), Kernel::scale, dimension, A_sketch_features, true);
+
+        Point p;
+        p.type = 0;
+        double *x = p.own_coordinates(dimension);
+        for(int i = 0; i < factor_A.n; ++i)
+        {
+            Map<Matrix<double,1,Dynamic>>(x, dimension) = X_A.row(i);
+            A_sketch->add_to_A(p);
+        }
+
+        factor_A = CholeskyFactor<>();
+        X_A.resize(0, X_A.cols());
+        b_A.resize(0);
+        y_A.resize(0);
+        pending_A_id = SIZE_MAX;
+    }
+
+    /**
+     * @brief Memory held to evaluate A
+     * @return Number of bytes
+     */
+    size_t bytes_A() const
+    {
+        if(A_sketch)
+        {
+            return A_sketch->bytes();
+        }
+        return (X_A.size() + b_A.size() + y_A.size())*sizeof(double) + factor_A.bytes();
+    }
+
+    /**
+     * @brief Calculate the delta_value after adding point to A \cap S, the points of the solution set that arrived before it
+     * With M ordered by arrival and the point last, its Schur complement is the square of the last diagonal entry of the factor
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @return Value after adding the point
+     */
+    double peek_delta_A_cap_S(const vector<Point> &cur_solution, const Point &cur_point)
+    {
+        ++query;
+
+        int S_size = cur_solution.size();
+        if(S_size > M_by_id.rows())
+        {
+            //Only reached when reserve() was not called with enough capacity
+            reserve(Capacity == Dynamic ? 2*S_size : S_size);
+        }
+
+        NoMallocScope no_malloc;
+
+        //Positions of the points in A \cap S in the order of arrival, followed by the position of cur_point
+        by_id.clear();
+        int cur_position = -1;
+        for(int i = 0; i < S_size; ++i)
+        {
+            if(cur_solution[i].id < cur_point.id)
+            {
+                by_id.push_back(i);
+            }
+            else if(cur_solution[i].id == cur_point.id)
+            {
+                cur_position = i;
+            }
+        }
+
+        if(cur_position < 0)
+        {
+            cout << "This point dosen't in the solution!!! \n";
+            exit(1);
+        }
+
+        sort(by_id.begin(), by_id.end(), [&](size_t i, size_t j)->bool{
+            return cur_solution[i].id < cur_solution[j].id;
+        });
+        by_id.push_back(cur_position);
+
+        int n = by_id.size();
+        factorize_by_id(n);
+        return Kernel::scale*2*log(factor_by_id.L(n-1,n-1));
+    }
+
+    /**
+     * @brief Calculate the delta_value of every point of the solution set after adding it to A \cap S, from one Cholesky factorization
+     * With M ordered by arrival, the Schur complement of a point with respect to the points before it is the square of its diagonal entry in the factor
+     * @param cur_solution : Current solution set
+     * @param fdeltas : Output, fdeltas[i] is the delta_value of cur_solution[i]
+     */
+    void delta_A_cap_S_all(const vector<Point> &cur_solution, vector<double> &fdeltas)
+    {
+        int S_size = cur_solution.size();
+        query += S_size;
+
+        fdeltas.resize(S_size);
+        if(S_size > M_by_id.rows())
+        {
+            //Only reached when reserve() was not called with enough capacity
+            reserve(Capacity == Dynamic ? 2*S_size : S_size);
+        }
+
+        NoMallocScope no_malloc;
+
+        //Positions of the solution set in the order of arrival
+        by_id.resize(S_size);
+        iota(by_id.begin(), by_id.end(), 0);
+        sort(by_id.begin(), by_id.end(), [&](size_t i, size_t j)->bool{
+            return cur_solution[i].id < cur_solution[j].id;
+        });
+
+        factorize_by_id(S_size);
+
+        //scale*log(L_ii^2)
+        for(int i = 0; i < S_size; ++i)
+        {
+            fdeltas[by_id[i]] = Kernel::scale*2*log(factor_by_id.L(i,i));
+        }
+    }
+
+    /**
+     * @brief Factorize the leading block of M in the order of by_id into factor_by_id
+     * @param n : Number of positions of by_id
+     */
+    void factorize_by_id(int n)
+    {
+        for(int j = 0; j < n; ++j)
+        {
+            for(int i = 0; i < n; ++i)
+            {
+                M_by_id(i,j) = M(by_id[i],by_id[j]);
+            }
+        }
+        factor_by_id.factorize(M_by_id.topLeftCorner(n,n));
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~KernelLogDet() {}
+};
+
+#endif // KERNELLOGDET_H
\ No newline at end of file
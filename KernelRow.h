@@ -0,0 +1,316 @@
+#ifndef KERNELROW_H
+#define KERNELROW_H
+
+#include <cmath>
+#include <cassert>
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELROW_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Kernel values between one point and all points of a solution set in one pass.
+ * The solution set is stored dimension-major, X[d*stride+i] being the d-th coordinate of the i-th point, so that |s_i - x|^2 is vectorized across points.
+ * It is summed from the differences of the coordinates rather than expanded as |s_i|^2 + |x|^2 - 2*s_i^T*x, which cancels for nearby points,
+ * so that all code paths agree. The widest instruction set supported by the CPU is chosen at run time.
+ * The vector code paths compute the last points in a masked block, so that a kernel value does not depend on the position of the point or on the number of points.
+ */
+
+class KernelRow
+{
+public:
+
+    //Kernel expressions, with r = |s_i - x|
+    enum Kernel
+    {
+        Gaussian,   //a*exp(-gamma*r^2)
+        Laplacian   //a*exp(-gamma*r)
+    };
+
+    //Instruction sets, in increasing order of width
+    enum ISA
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * @brief Instruction set in use. It is detected once and can be lowered, e.g. to compare the code paths
+     * @return Reference to the instruction set in use
+     */
+    static ISA& isa()
+    {
+        static ISA cur_isa = detect();
+        return cur_isa;
+    }
+
+    /**
+     * @brief Detect the widest instruction set supported by the CPU
+     * @return Instruction set
+     */
+    static ISA detect()
+    {
+#ifdef KERNELROW_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+        {
+            return AVX512;
+        }
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return AVX2;
+        }
+        if(__builtin_cpu_supports("sse2"))
+        {
+            return SSE2;
+        }
+#endif
+        return Scalar;
+    }
+
+    /**
+     * @brief Compute the kernel values between a point and n points
+     * @param kernel : Kernel expression
+     * @param a : Scale of the kernel
+     * @param gamma : Coefficient in the exponent
+     * @param X : Coordinates of the n points, dimension-major with the given stride
+     * @param stride : Distance between consecutive coordinates of the same point
+     * @param n : Number of points
+     * @param x : Coordinates of the point
+     * @param dim : Dimension
+     * @param out : Output, out[i] is the kernel value between the point and the i-th point
+     * @tparam Dim : Dimension known at compile time so that the loops over coordinates are unrolled, or -1 if it is only known at run time
+     */
+    template<int Dim = -1>
+    static void compute(Kernel kernel, double a, double gamma, const double *X, size_t stride, size_t n, const double *x, size_t dim, double *out)
+    {
+        const size_t D = Dim > 0 ? Dim : dim;
+
+        size_t done = 0;
+        switch(isa())
+        {
+#ifdef KERNELROW_X86
+        case AVX512:
+            done = compute_avx512<Dim>(kernel, a, gamma, X, stride, n, x, dim, out);
+            break;
+        case AVX2:
+            done = compute_avx2<Dim>(kernel, a, gamma, X, stride, n, x, dim, out);
+            break;
+        case SSE2:
+            done = compute_sse2<Dim>(kernel, a, gamma, X, stride, n, x, dim, out);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        //All points when no vector code path is available
+        for(size_t i = done; i < n; ++i)
+        {
+            double r2 = 0;
+            for(size_t d = 0; d < D; ++d)
+            {
+                double diff = X[d*stride+i] - x[d];
+                r2 += diff*diff;
+            }
+            out[i] = a*exp(-gamma*(kernel == Gaussian ? r2 : sqrt(r2)));
+        }
+    }
+
+    //Constants of the exponential, following Cephes: exp(x) = 2^m * exp(g) with |g| <= ln(2)/2 and a Pade approximation of exp(g)
+    static constexpr double exp_lo = -708.39;
+    static constexpr double log2e = 1.4426950408889634073599;
+    static constexpr double ln2_hi = 6.93145751953125E-1;
+    static constexpr double ln2_lo = 1.42860682030941723212E-6;
+    static constexpr double P0 = 1.26177193074810590878E-4;
+    static constexpr double P1 = 3.02994407707441961300E-2;
+    static constexpr double P2 = 9.99999999999999999910E-1;
+    static constexpr double Q0 = 3.00198505138664455042E-6;
+    static constexpr double Q1 = 2.52448340349684104192E-3;
+    static constexpr double Q2 = 2.27265548208155028766E-1;
+    static constexpr double Q3 = 2.00000000000000000009E0;
+    //Adding 1.5*2^52 rounds a double to an integer, and adding 2^52+1023 puts the biased exponent in the low bits
+    static constexpr double round_magic = 6755399441055744.0;
+    static constexpr double exponent_magic = 4503599627371519.0;
+
+#ifdef KERNELROW_X86
+    /**
+     * @brief exp(x) for x <= 0 in two lanes, 0 below exp_lo
+     */
+    __attribute__((target("sse2")))
+    static __m128d exp_sse2(__m128d x)
+    {
+        __m128d underflow = _mm_cmplt_pd(x, _mm_set1_pd(exp_lo));
+        x = _mm_max_pd(x, _mm_set1_pd(exp_lo));
+
+        __m128d m = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(log2e)), _mm_set1_pd(round_magic)), _mm_set1_pd(round_magic));
+        __m128d g = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(m, _mm_set1_pd(ln2_hi))), _mm_mul_pd(m, _mm_set1_pd(ln2_lo)));
+
+        __m128d gg = _mm_mul_pd(g, g);
+        __m128d px = _mm_mul_pd(g, _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(P0), gg), _mm_set1_pd(P1)), gg), _mm_set1_pd(P2)));
+        __m128d qx = _mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(Q0), gg), _mm_set1_pd(Q1)), gg), _mm_set1_pd(Q2)), gg), _mm_set1_pd(Q3));
+        __m128d e = _mm_div_pd(px, _mm_sub_pd(qx, px));
+        e = _mm_add_pd(_mm_set1_pd(1.0), _mm_add_pd(e, e));
+
+        __m128i bits = _mm_slli_epi64(_mm_castpd_si128(_mm_add_pd(m, _mm_set1_pd(exponent_magic))), 52);
+        e = _mm_mul_pd(e, _mm_castsi128_pd(bits));
+
+        return _mm_andnot_pd(underflow, e);
+    }
+
+    /**
+     * @brief Kernel values of all points in blocks of two lanes, the last point of an odd number being in the low lane only
+     * @return Number of points computed
+     */
+    template<int Dim>
+    __attribute__((target("sse2")))
+    static size_t compute_sse2(Kernel kernel, double a, double gamma, const double *X, size_t stride, size_t n, const double *x, size_t dim, double *out)
+    {
+        const size_t D = Dim > 0 ? Dim : dim;
+
+        for(size_t i = 0; i < n; i += 2)
+        {
+            bool full = i+2 <= n;
+            __m128d r2 = _mm_setzero_pd();
+            for(size_t d = 0; d < D; ++d)
+            {
+                __m128d s = full ? _mm_loadu_pd(X+d*stride+i) : _mm_load_sd(X+d*stride+i);
+                __m128d diff = _mm_sub_pd(s, _mm_set1_pd(x[d]));
+                r2 = _mm_add_pd(r2, _mm_mul_pd(diff, diff));
+            }
+            __m128d r = (kernel == Gaussian) ? r2 : _mm_sqrt_pd(r2);
+            __m128d k = _mm_mul_pd(_mm_set1_pd(a), exp_sse2(_mm_mul_pd(_mm_set1_pd(-gamma), r)));
+            if(full)
+            {
+                _mm_storeu_pd(out+i, k);
+            }
+            else
+            {
+                _mm_store_sd(out+i, k);
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief exp(x) for x <= 0 in four lanes, 0 below exp_lo
+     */
+    __attribute__((target("avx2,fma")))
+    static __m256d exp_avx2(__m256d x)
+    {
+        __m256d underflow = _mm256_cmp_pd(x, _mm256_set1_pd(exp_lo), _CMP_LT_OQ);
+        x = _mm256_max_pd(x, _mm256_set1_pd(exp_lo));
+
+        __m256d m = _mm256_sub_pd(_mm256_fmadd_pd(x, _mm256_set1_pd(log2e), _mm256_set1_pd(round_magic)), _mm256_set1_pd(round_magic));
+        __m256d g = _mm256_fnmadd_pd(m, _mm256_set1_pd(ln2_lo), _mm256_fnmadd_pd(m, _mm256_set1_pd(ln2_hi), x));
+
+        __m256d gg = _mm256_mul_pd(g, g);
+        __m256d px = _mm256_mul_pd(g, _mm256_fmadd_pd(_mm256_fmadd_pd(_mm256_set1_pd(P0), gg, _mm256_set1_pd(P1)), gg, _mm256_set1_pd(P2)));
+        __m256d qx = _mm256_fmadd_pd(_mm256_fmadd_pd(_mm256_fmadd_pd(_mm256_set1_pd(Q0), gg, _mm256_set1_pd(Q1)), gg, _mm256_set1_pd(Q2)), gg, _mm256_set1_pd(Q3));
+        __m256d e = _mm256_div_pd(px, _mm256_sub_pd(qx, px));
+        e = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_add_pd(e, e));
+
+        __m256i bits = _mm256_slli_epi64(_mm256_castpd_si256(_mm256_add_pd(m, _mm256_set1_pd(exponent_magic))), 52);
+        e = _mm256_mul_pd(e, _mm256_castsi256_pd(bits));
+
+        return _mm256_andnot_pd(underflow, e);
+    }
+
+    /**
+     * @brief Kernel values of all points in blocks of four lanes, the lanes beyond the last point being masked
+     * @return Number of points computed
+     */
+    template<int Dim>
+    __attribute__((target("avx2,fma")))
+    static size_t compute_avx2(Kernel kernel, double a, double gamma, const double *X, size_t stride, size_t n, const double *x, size_t dim, double *out)
+    {
+        const size_t D = Dim > 0 ? Dim : dim;
+
+        for(size_t i = 0; i < n; i += 4)
+        {
+            //Lanes of the block that hold a point, whose masked loads read nothing beyond it
+            __m256i lanes = _mm256_cmpgt_epi64(_mm256_set1_epi64x(n-i), _mm256_setr_epi64x(0, 1, 2, 3));
+            __m256d r2 = _mm256_setzero_pd();
+            for(size_t d = 0; d < D; ++d)
+            {
+                __m256d diff = _mm256_sub_pd(_mm256_maskload_pd(X+d*stride+i, lanes), _mm256_set1_pd(x[d]));
+                r2 = _mm256_fmadd_pd(diff, diff, r2);
+            }
+            __m256d r = (kernel == Gaussian) ? r2 : _mm256_sqrt_pd(r2);
+            __m256d k = _mm256_mul_pd(_mm256_set1_pd(a), exp_avx2(_mm256_mul_pd(_mm256_set1_pd(-gamma), r)));
+            if(i+4 <= n)
+            {
+                _mm256_storeu_pd(out+i, k);
+            }
+            else
+            {
+                _mm256_maskstore_pd(out+i, lanes, k);
+            }
+        }
+        return n;
+    }
+
+    /**
+     * @brief exp(x) for x <= 0 in eight lanes, 0 below exp_lo
+     */
+    __attribute__((target("avx512f")))
+    static __m512d exp_avx512(__m512d x)
+    {
+        //The masked forms with an explicit source are used, since the plain ones start from an undefined vector
+        const __mmask8 all = 0xFF;
+        __mmask8 underflow = _mm512_cmp_pd_mask(x, _mm512_set1_pd(exp_lo), _CMP_LT_OQ);
+        x = _mm512_mask_max_pd(_mm512_setzero_pd(), all, x, _mm512_set1_pd(exp_lo));
+
+        __m512d m = _mm512_sub_pd(_mm512_fmadd_pd(x, _mm512_set1_pd(log2e), _mm512_set1_pd(round_magic)), _mm512_set1_pd(round_magic));
+        __m512d g = _mm512_fnmadd_pd(m, _mm512_set1_pd(ln2_lo), _mm512_fnmadd_pd(m, _mm512_set1_pd(ln2_hi), x));
+
+        __m512d gg = _mm512_mul_pd(g, g);
+        __m512d px = _mm512_mul_pd(g, _mm512_fmadd_pd(_mm512_fmadd_pd(_mm512_set1_pd(P0), gg, _mm512_set1_pd(P1)), gg, _mm512_set1_pd(P2)));
+        __m512d qx = _mm512_fmadd_pd(_mm512_fmadd_pd(_mm512_fmadd_pd(_mm512_set1_pd(Q0), gg, _mm512_set1_pd(Q1)), gg, _mm512_set1_pd(Q2)), gg, _mm512_set1_pd(Q3));
+        __m512d e = _mm512_div_pd(px, _mm512_sub_pd(qx, px));
+        e = _mm512_add_pd(_mm512_set1_pd(1.0), _mm512_add_pd(e, e));
+
+        __m512i bits = _mm512_mask_slli_epi64(_mm512_setzero_si512(), all, _mm512_castpd_si512(_mm512_add_pd(m, _mm512_set1_pd(exponent_magic))), 52);
+        e = _mm512_mul_pd(e, _mm512_castsi512_pd(bits));
+
+        return _mm512_maskz_mov_pd((__mmask8)~underflow, e);
+    }
+
+    /**
+     * @brief Kernel values of all points in blocks of eight lanes, the lanes beyond the last point being masked
+     * @return Number of points computed
+     */
+    template<int Dim>
+    __attribute__((target("avx512f")))
+    static size_t compute_avx512(Kernel kernel, double a, double gamma, const double *X, size_t stride, size_t n, const double *x, size_t dim, double *out)
+    {
+        const size_t D = Dim > 0 ? Dim : dim;
+        const __mmask8 all = 0xFF;
+        const __m512d zero = _mm512_setzero_pd();
+
+        for(size_t i = 0; i < n; i += 8)
+        {
+            //Lanes of the block that hold a point, whose masked loads read nothing beyond it
+            __mmask8 lanes = (n-i >= 8) ? all : (__mmask8)((1u << (n-i)) - 1);
+            __m512d r2 = zero;
+            for(size_t d = 0; d < D; ++d)
+            {
+                __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(lanes, X+d*stride+i), _mm512_set1_pd(x[d]));
+                r2 = _mm512_fmadd_pd(diff, diff, r2);
+            }
+            __m512d r = (kernel == Gaussian) ? r2 : _mm512_mask_sqrt_pd(zero, all, r2);
+            __m512d k = exp_avx512(_mm512_mul_pd(_mm512_set1_pd(-gamma), r));
+            _mm512_mask_storeu_pd(out+i, lanes, _mm512_mul_pd(_mm512_set1_pd(a), k));
+        }
+        return n;
+    }
+#endif
+};
+
+#endif // KERNELROW_H
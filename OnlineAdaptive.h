@@ -13,9 +13,13 @@
 
 using namespace std;
 
-class OnlineAdaptive : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class OnlineAdaptiveT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
+
     //Parameters that determine the threshold
     double beta;
     double eta;
@@ -23,6 +27,12 @@ public:
     //Weighted sum of marginal gains in the solution set
     double tau = 0;
 
+    //Positions in the solution set in descending order of fdelta
+    vector<size_t> order;
+
+    //Marginal gain of each point of the solution set when it was added, indexed by positions in the solution set
+    vector<double> fdeltas;
+
     //As the solution set increases, parameter alpha expands to "r" times its original size
     double r;
 
@@ -32,7 +42,7 @@ public:
      * @param f: Submodular function
      * @param r: Relaxation parameter
      */
-    OnlineAdaptive(size_t k, SubmodularFunction &f, double r) : SubsetSelectionAlgorithm(k, f), r(r)
+    OnlineAdaptiveT(size_t k, F &f, double r) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f)), r(r)
     {
         //eta is the positive root of the equation $(1+x)^{(k+1)}=kx+x+2$
         //Store some values of eta in advance
@@ -82,9 +92,15 @@ public:
      */
     void next(const Point &cur_point)
     {  
-        Point t(cur_point);
-        double fdelta = f.peek(solution, t, solution.size()) - fval;
-        t.fdelta = fdelta;
+        //Reject without the exact evaluation when an upper bound of the marginal gain is already below the threshold
+        if(f.gain_upper_bound(solution, cur_point) < beta*tau/k)
+        {
+            ++skipped;
+            return;
+        }
+
+        SubmodularFunction::Evaluation eval;
+        double fdelta = f.peek(solution, cur_point, solution.size(), eval) - fval;
 
         if(fdelta < beta*tau/k)
         {
@@ -94,13 +110,16 @@ public:
         if (solution.size() < k)
         {
             //Add to the solution set directly 
-            f.update(solution, t, solution.size());   
+            order.push_back(solution.size());
+            fdeltas.push_back(fdelta);
+            f.commit(solution, cur_point, solution.size(), eval);   
             fval = f.operator()(solution);
         }
         else
         {
-            //Replace the point at the end
-            f.update(solution, t, solution.size()-1); 
+            //Replace the point at the end of the order
+            fdeltas[order.back()] = fdelta;
+            f.commit(solution, cur_point, order.back(), eval); 
             fval = f.operator()(solution);
         }
         double exponent = log(log(k)/log(1.2))/log(2);
@@ -108,20 +127,22 @@ public:
         beta = (1+k*alpha) / (pow(1+alpha, k)-1);
         
         //Descend order
-        f.sort_descend_fdelta(solution);
+        f.sort_descend_fdelta(fdeltas, order);
         
         //Update tau
         tau = 0;
         for(size_t i = 0 ; i < solution.size(); ++i)
         {
-            tau += pow(1+alpha, i) * solution[i].fdelta;
+            tau += pow(1+alpha, i) * fdeltas[order[i]];
         }
     }
 
     /**
      * @brief Destructor
      */
-    ~OnlineAdaptive() {}
+    ~OnlineAdaptiveT() {}
 };
 
+typedef OnlineAdaptiveT<> OnlineAdaptive;
+
 #endif
\ No newline at end of file
@@ -4,10 +4,21 @@
 #include <vector>
 #include <cassert>
 #include <cmath>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 
+#include "VectorStore.h"
+#include "TokenStore.h"
+
 using namespace std;
 
+/**
+ * @brief A point of a dataset, which refers to its coordinates in the VectorStore or to its words in the TokenStore of the dataset,
+ * so that copying a point copies no coordinates and no words
+ */
+
 class Point
 {
 public:
@@ -22,15 +33,16 @@ public:
     size_t id;
 
     //Used for numerical vector
-    //Numerical components
-    vector<double> coordinates;
-
-    //Marginal gain of the point when it is accepted
-    double fdelta = 0;
+    //Numerical components, a view of the VectorStore of the dataset or of storage
+    const double *coordinates = nullptr;
+    //Coordinates of a point that is not in a VectorStore, such as the result of an arithmetic operation, shared by the copies of the point
+    shared_ptr<vector<double>> storage;
 
     //Used for non numerical vector，such as the "Twitter" dataset 
-    //Non numerical components
-    vector<string> words;
+    //Non numerical components, the ids of the words in the TokenStore of the dataset
+    const uint32_t *words = nullptr;
+    //The TokenStore that holds the words
+    const TokenStore *token_store = nullptr;
     //Retweets
     double retweets;
 
@@ -48,12 +60,8 @@ public:
      */
     Point(size_t dimension)
     {
-        this->dimension = dimension;
         this->type = 0;
-        for(size_t i = 0; i < dimension; ++i)
-        {
-            coordinates.push_back(0);
-        }
+        own_coordinates(dimension);
     }
 
     /**
@@ -67,48 +75,195 @@ public:
         assert(dimension == coordinates.size());
 
         this->id = id;
-        this->dimension = dimension;
-        this->coordinates = coordinates;
+        this->type = 0;
+        copy(coordinates.begin(), coordinates.end(), own_coordinates(dimension));
+    }
+
+    /**
+     * @brief Constructor for a numerical vector of a dataset
+     * @param id: The position in the dataset
+     * @param vector_store: The coordinates of the dataset
+     * @param i: The index of the vector in vector_store
+     */
+    Point(size_t id, const VectorStore &vector_store, size_t i)
+    {
+        this->id = id;
+        this->dimension = vector_store.dimension;
+        this->coordinates = vector_store.vector_at(i);
         this->type = 0;
     }
 
+    /**
+     * @brief Give the point coordinates of its own, which are 0 when the storage is new. The storage is reused when no other point shares it
+     * @param dimension: The dimension of the vector
+     * @return The coordinates, which may be written
+     */
+    double* own_coordinates(size_t dimension)
+    {
+        if(!storage || storage.use_count() > 1)
+        {
+            storage = make_shared<vector<double>>(dimension, 0);
+        }
+        else
+        {
+            storage->resize(dimension);
+        }
+
+        this->dimension = dimension;
+        coordinates = storage->data();
+        return storage->data();
+    }
+
+    /**
+     * @brief Copy the coordinates into storage of the point's own unless it already owns them alone, so that they may be written
+     * @return The coordinates, which may be written
+     */
+    double* writable_coordinates()
+    {
+        if(!storage || storage.use_count() > 1 || storage->data() != coordinates)
+        {
+            storage = make_shared<vector<double>>(coordinates, coordinates + dimension);
+            coordinates = storage->data();
+        }
+        return storage->data();
+    }
+
     /**
      * @brief Constructor for a non numerical vector
      * @param id: The position in the dataset
-     * @param dimension: The dimension of the vector/The number of words
-     * @param words: The non numerical components of the vector
+     * @param token_store: The words of the dataset
+     * @param text: The index of the text of the vector in token_store
      * @param retweets: Retweets
      */
-    Point(size_t id, size_t dimension, vector<string>& words, double retweets)
+    Point(size_t id, const TokenStore &token_store, size_t text, double retweets)
     {
-        assert(dimension == words.size());
-
         this->id = id;
-        this->dimension = dimension;
-        this->words = words;
+        this->dimension = token_store.text_size(text);
+        this->words = token_store.text(text);
+        this->token_store = &token_store;
         this->retweets = retweets;
         this->type = 1;
     }
 
+    //Range of the ids of the words, for range-based loops
+    struct WordIds
+    {
+        const uint32_t *first;
+        const uint32_t *last;
+
+        const uint32_t* begin() const
+        {
+            return first;
+        }
+
+        const uint32_t* end() const
+        {
+            return last;
+        }
+    };
+
     /**
-     * @brief Vectors' dot multiplication
-     * @param other_point: Another point
-     * @return The result of dot multiplication
+     * @brief The ids of the words of a non numerical vector
+     * @return Range of the ids
      */
-    double dotP(const Point &other_point) const
+    WordIds word_ids() const
     {
-        assert(dimension == other_point.dimension);
-        assert(type == other_point.type);
+        assert(type == 1);
+        return WordIds{words, words + dimension};
+    }
 
+    /**
+     * @brief Dot product of two spans of coordinates, without allocation
+     * @param x: Coordinates of a vector
+     * @param y: Coordinates of another vector
+     * @param dimension: The dimension of the vectors
+     * @return The result of dot multiplication
+     */
+    static double dot(const double *x, const double *y, size_t dimension)
+    {
         double dotp = 0.0;
         for(size_t i = 0; i < dimension; ++i)
         {
-            dotp += coordinates[i] * other_point.coordinates[i];
+            dotp += x[i] * y[i];
         }
 
         return dotp;
     }
 
+    /**
+     * @brief Squared second norm distance between two spans of coordinates, without allocation
+     * @param x: Coordinates of a vector
+     * @param y: Coordinates of another vector
+     * @param dimension: The dimension of the vectors
+     * @return Squared distance
+     */
+    static double squared_distance(const double *x, const double *y, size_t dimension)
+    {
+        double squared_distance = 0.0;
+        for(size_t i = 0; i < dimension; ++i)
+        {
+            double diff = x[i] - y[i];
+            squared_distance += diff * diff;
+        }
+
+        return squared_distance;
+    }
+
+    /**
+     * @brief Difference of two spans of coordinates, without allocation
+     * @param x: Coordinates of a vector
+     * @param y: Coordinates of the subtracted vector
+     * @param dimension: The dimension of the vectors
+     * @param out: Output, x - y, which may be x or y
+     */
+    static void subtract(const double *x, const double *y, size_t dimension, double *out)
+    {
+        for(size_t i = 0; i < dimension; ++i)
+        {
+            out[i] = x[i] - y[i];
+        }
+    }
+
+    /**
+     * @brief Multiply a span of coordinates by a constant in place
+     * @param x: Coordinates of a vector
+     * @param dimension: The dimension of the vector
+     * @param factor: The constant
+     */
+    static void scale(double *x, size_t dimension, double factor)
+    {
+        for(size_t i = 0; i < dimension; ++i)
+        {
+            x[i] *= factor;
+        }
+    }
+
+    /**
+     * @brief Take absolute values of a span of coordinates in place
+     * @param x: Coordinates of a vector
+     * @param dimension: The dimension of the vector
+     */
+    static void abs(double *x, size_t dimension)
+    {
+        for(size_t i = 0; i < dimension; ++i)
+        {
+            x[i] = std::abs(x[i]);
+        }
+    }
+
+    /**
+     * @brief Vectors' dot multiplication
+     * @param other_point: Another point
+     * @return The result of dot multiplication
+     */
+    double dotP(const Point &other_point) const
+    {
+        assert(dimension == other_point.dimension);
+        assert(type == other_point.type);
+
+        return dot(coordinates, other_point.coordinates, dimension);
+    }
+
     /**
      * @brief Determine whether a vector dominates another
      * @param other_point: Another point
@@ -152,15 +307,16 @@ public:
 
         double factor = (mylen > 0) ? (len / mylen) : 0;
 
+        double *x = writable_coordinates();
         for(size_t i = 0; i < dimension; ++i)
         {
-            coordinates[i] *= factor;
-            coordinates[i] *= coordinates[i];
+            x[i] *= factor;
+            x[i] *= x[i];
         }    
     }
 
     /**
-     * @brief Vectors' subtraction
+     * @brief Vectors' subtraction, which allocates the result, see subtract() for spans
      * @param other_point: Another point
      * @return The result of subtraction
      */
@@ -170,17 +326,13 @@ public:
         assert(type == other_point.type);
 
         Point diff(dimension);
-
-        for(size_t i = 0; i < dimension; ++i)
-        {
-            diff.coordinates[i] = coordinates[i] - other_point.coordinates[i];
-        }
+        subtract(coordinates, other_point.coordinates, dimension, diff.writable_coordinates());
 
         return diff;
     }
 
     /**
-     * @brief A vector multiplied by an constant
+     * @brief A vector multiplied by an constant, which allocates the result, see scale() for spans
      * @param factor: The constant
      * @return The result of multiplication
      */
@@ -189,17 +341,15 @@ public:
         assert(type == 0);
 
         Point mult(dimension);
-
-        for(size_t i = 0; i < dimension; ++i)
-        {
-            mult.coordinates[i] = coordinates[i] * factor;
-        }
+        double *x = mult.writable_coordinates();
+        copy(coordinates, coordinates + dimension, x);
+        scale(x, dimension, factor);
 
         return mult;
     }
 
     /**
-     * @brief Calculate the second norm distance between vectors
+     * @brief Calculate the second norm distance between vectors, without allocation
      * @param other_point: Another point
      * @return Second norm distance
      */
@@ -208,9 +358,21 @@ public:
         assert(type == other_point.type);
         assert(type == 0);
 
-        Point diff = (*this) - other_point;
+        return sqrt(squared_distance_to(other_point));
+    }
 
-        return diff.length();
+    /**
+     * @brief Calculate the squared second norm distance between vectors, without allocation
+     * @param other_point: Another point
+     * @return Squared distance
+     */
+    double squared_distance_to(const Point &other_point) const
+    {
+        assert(type == other_point.type);
+        assert(type == 0);
+        assert(dimension == other_point.dimension);
+
+        return squared_distance(coordinates, other_point.coordinates, dimension);
     }
 
     /**
@@ -221,14 +383,7 @@ public:
     {
         assert(type == 0);
 
-        double length = 0;
-
-        for(size_t i = 0; i < dimension; ++i)
-        {
-            length += coordinates[i] * coordinates[i];
-        }
-
-        return sqrt(length);
+        return sqrt(dot(coordinates, coordinates, dimension));
     }
 
     /**
@@ -258,9 +413,9 @@ public:
             cout << "[ ";
             for(size_t i = 0; i < dimension-1; ++i)
             {
-                cout << words[i] << ", ";
+                cout << token_store->words[words[i]] << ", ";
             }
-            cout << words[dimension - 1];
+            cout << token_store->words[words[dimension - 1]];
             cout << " ]";
             cout << suffix;
             cout << endl;
@@ -268,7 +423,7 @@ public:
     }
 
     /**
-     * @brief Take absolute values of numerical components of a vector
+     * @brief Take absolute values of numerical components of a vector, which allocates the result, see abs() for spans
      * @param other_point: A point
      */
     static Point abs(const Point &other_point)
@@ -276,10 +431,9 @@ public:
         assert(other_point.type == 0);
 
         Point p(other_point.dimension);
-        for(size_t i = 0; i < other_point.dimension; ++i)
-        {
-            p.coordinates[i] = std::abs(other_point.coordinates[i]);
-        }
+        double *x = p.writable_coordinates();
+        copy(other_point.coordinates, other_point.coordinates + other_point.dimension, x);
+        abs(x, other_point.dimension);
 
         return p;
     }
@@ -11,9 +11,12 @@
 
 using namespace std;
 
-class Preemption : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class PreemptionT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
 
     //Parameter that determines the threshold
     double c;
@@ -24,7 +27,7 @@ public:
      * @param f: Submodular function
      * @param c: Parameter that determine the threshold
      */
-    Preemption(size_t k, SubmodularFunction &f, double c) : SubsetSelectionAlgorithm(k, f), c(c)
+    PreemptionT(size_t k, F &f, double c) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f)), c(c)
     {
         
     }
@@ -76,6 +79,7 @@ public:
             if (fval_max - fval >= c * fval / k)
             {
                 //Perform the replacement
+                //Only the evaluation of the last position is kept by f, so the best one is recomputed by update() rather than committed
                 f.update(solution, cur_point, fval_max_position);
                 fval = fval_max;
             }
@@ -85,7 +89,9 @@ public:
     /**
      * @brief Destructor
      */
-    ~Preemption() {}
+    ~PreemptionT() {}
 };
 
+typedef PreemptionT<> Preemption;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,674 @@
+#ifndef SPARSEGAUVECSUBFUNC_H
+#define SPARSEGAUVECSUBFUNC_H
+
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include <cassert>
+#include <iostream>
+#include <Eigen/Dense>
+#include <Eigen/Core>
+
+#include "SubmodularFunction.h"
+#include "CholeskyFactor.h"
+#include "Point.h"
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Sparse version of GauVecSubFunc, opt-in: kernel values between points farther apart than a cutoff radius are taken as 0.
+ * M is then block diagonal over the connected components of the "within the radius" graph, so log(det(M)) is the sum over the components.
+ * Neighbors within the radius are found with a uniform grid of cells of the size of the radius, over the first (at most three) coordinates.
+ * When the points of the solution set are well separated, the components are small and an arrival costs nearly constant time instead of O(k^3).
+ * Otherwise, as on normalized data with the default radius, they merge into one component and the dense GauVecSubFunc is faster.
+ */
+
+class SparseGauVecSubFunc final : public SubmodularFunction
+{
+public:
+
+    //Vector dimension
+    size_t dimension;
+    //Parameters, the same as GauVecSubFunc
+    double l;
+    double a;
+    //Cutoff radius of the kernel
+    double radius;
+
+    //Keep the peek() of the base class that returns an evaluation handle visible next to the override below
+    using SubmodularFunction::peek;
+
+    /**
+     * @brief A set of points with the sparse kernel matrix of its connected components factorized
+     */
+    struct SparseKernelSet
+    {
+        //A connected component: its points in the order of arrival and the Cholesky factor of their kernel matrix in that order,
+        //so that the square of the i-th diagonal entry of the factor is the Schur complement of the i-th point with respect to the points before it
+        struct Component
+        {
+            vector<size_t> members;
+            CholeskyFactor<> factor;
+        };
+
+        //Owner, for the kernel parameters
+        const SparseGauVecSubFunc *f;
+        //Coordinates of the points, indexed by positions
+        vector<vector<double>> X;
+        //Ids of the points, which give their order of arrival
+        vector<size_t> ids;
+        //Component of each point, and its index in the members of the component
+        vector<int> component_of;
+        vector<size_t> index_of;
+        //Components by their ids
+        unordered_map<int,Component> components;
+        //Id of the next component
+        int next_component;
+        //Points of each grid cell
+        unordered_map<size_t,vector<size_t>> cells;
+        //log(det(M)) of all points
+        double log_det;
+
+        //Workspaces of peek(), kept across calls so that a peek does not allocate once they have grown to the largest component
+        //Neighbors of the evaluated point, the components they touch, the kernel values of the point with a component and their solution with its factor
+        vector<size_t> neighbors;
+        vector<int> touched;
+        Matrix<double,Dynamic,1> b;
+        Matrix<double,Dynamic,1> y;
+
+        SparseKernelSet()
+        {
+            f = nullptr;
+            next_component = 0;
+            log_det = 0;
+        }
+
+        /**
+         * @brief Number of coordinates used by the grid
+         * @param dimension : Vector dimension
+         * @return Number of coordinates
+         */
+        static size_t grid_dimension(size_t dimension)
+        {
+            return min<size_t>(dimension, 3);
+        }
+
+        /**
+         * @brief Key of the grid cell that contains the point after shifting it by offsets cells
+         * @param x : Coordinates
+         * @param offsets : Shift along each coordinate of the grid, in cells
+         * @return Key of the cell
+         */
+        size_t cell_key(const double *x, const int *offsets) const
+        {
+            size_t key = 0;
+            for(size_t d = 0; d < grid_dimension(f->dimension); ++d)
+            {
+                long long cell = (long long)floor(x[d]/f->radius) + offsets[d];
+                key = key*1000003 + (size_t)cell;
+            }
+            return key;
+        }
+
+        /**
+         * @brief Find the points within the cutoff radius of x, into neighbors
+         * @param x : Coordinates
+         * @param exclude : Position that is skipped, or a position out of range
+         */
+        void find_neighbors(const double *x, size_t exclude)
+        {
+            neighbors.clear();
+
+            //Visit the 3^g cells around the cell of x
+            size_t g = grid_dimension(f->dimension);
+            int offsets[3] = {-1, -1, -1};
+            size_t visits = 1;
+            for(size_t d = 0; d < g; ++d)
+            {
+                visits *= 3;
+            }
+            for(size_t v = 0; v < visits; ++v)
+            {
+                size_t rest = v;
+                for(size_t d = 0; d < g; ++d)
+                {
+                    offsets[d] = int(rest%3) - 1;
+                    rest /= 3;
+                }
+
+                auto it = cells.find(cell_key(x, offsets));
+                if(it == cells.end())
+                {
+                    continue;
+                }
+                for(size_t i : it->second)
+                {
+                    if(i != exclude && squared_distance(X[i].data(), x, f->dimension) <= f->radius*f->radius)
+                    {
+                        neighbors.push_back(i);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Add a position to the cell of x
+         */
+        void insert_cell(const double *x, size_t i)
+        {
+            static const int center[3] = {0, 0, 0};
+            cells[cell_key(x, center)].push_back(i);
+        }
+
+        /**
+         * @brief Remove a position from the cell of x
+         */
+        void erase_cell(const double *x, size_t i)
+        {
+            static const int center[3] = {0, 0, 0};
+            auto &cell = cells[cell_key(x, center)];
+            cell.erase(find(cell.begin(), cell.end(), i));
+        }
+
+        /**
+         * @brief Squared distance between two points
+         */
+        static double squared_distance(const double *x, const double *y, size_t dimension)
+        {
+            return Point::squared_distance(x, y, dimension);
+        }
+
+        /**
+         * @brief Kernel matrix of a set of points, with the values beyond the radius set to 0
+         * @param points : Coordinates of the points
+         * @return Kernel matrix
+         */
+        Matrix<double,Dynamic,Dynamic> kernel_matrix(const vector<const double*> &points) const
+        {
+            int n = points.size();
+            Matrix<double,Dynamic,Dynamic> M(n, n);
+            for(int i = 0; i < n; ++i)
+            {
+                M(i,i) = 1+f->a;
+                for(int j = i+1; j < n; ++j)
+                {
+                    M(i,j) = f->kernel(squared_distance(points[i], points[j], f->dimension));
+                    M(j,i) = M(i,j);
+                }
+            }
+            return M;
+        }
+
+        /**
+         * @brief Collect the components touched by the neighbors of a point, together with the component of a replaced point
+         * @param replaced : Position of the replaced point, or a position out of range
+         */
+        void touched_components(size_t replaced)
+        {
+            touched.clear();
+            if(replaced < X.size())
+            {
+                touched.push_back(component_of[replaced]);
+            }
+            for(size_t i : neighbors)
+            {
+                if(find(touched.begin(), touched.end(), component_of[i]) == touched.end())
+                {
+                    touched.push_back(component_of[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Compute the kernel values between x and the members of a component into the workspace b
+         * @param component : Component
+         * @param x : Coordinates of the point
+         * @return Number of members
+         */
+        int kernel_values(const Component &component, const double *x)
+        {
+            int m = component.members.size();
+            if(b.size() < m)
+            {
+                //Only reached when a component is larger than all the previous ones
+                b.resize(2*m);
+                y.resize(2*m);
+            }
+            for(int i = 0; i < m; ++i)
+            {
+                b(i) = f->kernel(squared_distance(X[component.members[i]].data(), x, f->dimension));
+            }
+            return m;
+        }
+
+        /**
+         * @brief log(det(M)) after adding x at a position, from the factors of the components it touches
+         * @param x : Coordinates of the point
+         * @param position : Position, the end to append
+         * @return log(det(M)) after adding the point
+         */
+        double peek(const double *x, size_t position)
+        {
+            find_neighbors(x, position);
+            touched_components(position);
+
+            if(position == X.size())
+            {
+                //Append: the Schur complement is 1+a - sum over the touched components of b_c^T * M_c^{-1} * b_c
+                double schur = 1+f->a;
+                for(int c : touched)
+                {
+                    const Component &component = components.at(c);
+                    int m = kernel_values(component, x);
+                    //With the diagonal entry 0, the Schur complement is -b_c^T * M_c^{-1} * b_c
+                    schur += component.factor.schur_complement(b.head(m), 0, y.head(m));
+                }
+                return log_det + log(schur);
+            }
+
+            //Replace: the column of the replaced point changes by u, which reaches the other touched components through the neighbors of x.
+            //M is block diagonal over the components, so the change is scored with the matrix determinant lemma on the factor of the component
+            //of the replaced point, the other components only adding their u_c^T * M_c^{-1} * u_c = b_c^T * M_c^{-1} * b_c
+            double outside = 0;
+            for(size_t t = 1; t < touched.size(); ++t)
+            {
+                const Component &component = components.at(touched[t]);
+                int m = kernel_values(component, x);
+                outside -= component.factor.schur_complement(b.head(m), 0, y.head(m));
+            }
+
+            const Component &component = components.at(touched[0]);
+            int m = kernel_values(component, x);
+            size_t p = index_of[position];
+            for(int i = 0; i < m; ++i)
+            {
+                if((size_t)i != p)
+                {
+                    b(i) -= f->kernel(squared_distance(X[component.members[i]].data(), X[position].data(), f->dimension));
+                }
+            }
+            b(p) = 0;
+
+            return log_det + log(component.factor.replace_ratio(p, b.head(m), outside));
+        }
+
+        /**
+         * @brief Add x at a position and refactorize the components it touches
+         * @param x : Coordinates of the point
+         * @param id : Id of the point
+         * @param position : Position, the end to append
+         */
+        void update(const double *x, size_t id, size_t position)
+        {
+            find_neighbors(x, position);
+            touched_components(position);
+
+            if(position == X.size() && touched.size() <= 1 && (touched.empty() || ids[components.at(touched[0]).members.back()] < id))
+            {
+                //Append of the last arrival to at most one component, whose factor in the order of arrival gains one row
+                append(x, id);
+                return;
+            }
+
+            //Points of the touched components, and the added point
+            vector<size_t> affected;
+            for(int c : touched)
+            {
+                auto it = components.find(c);
+                affected.insert(affected.end(), it->second.members.begin(), it->second.members.end());
+                log_det -= it->second.factor.log_det;
+                components.erase(it);
+            }
+
+            if(position == X.size())
+            {
+                X.push_back(vector<double>(x, x + f->dimension));
+                ids.push_back(id);
+                component_of.push_back(-1);
+                index_of.push_back(0);
+                affected.push_back(position);
+            }
+            else
+            {
+                erase_cell(X[position].data(), position);
+                X[position].assign(x, x + f->dimension);
+                ids[position] = id;
+            }
+            insert_cell(x, position);
+
+            //Removing a point may split its component, so the affected points are regrouped
+            build_components(affected);
+        }
+
+        /**
+         * @brief Append x after all the points of the component it touches, or as a component of its own, with one more row of the factor
+         * @param x : Coordinates of the point
+         * @param id : Id of the point, larger than those of the component it touches
+         */
+        void append(const double *x, size_t id)
+        {
+            size_t position = X.size();
+            X.push_back(vector<double>(x, x + f->dimension));
+            ids.push_back(id);
+            insert_cell(x, position);
+
+            int c = next_component;
+            if(touched.empty())
+            {
+                components[next_component++];
+            }
+            else
+            {
+                c = touched[0];
+            }
+            Component &component = components.at(c);
+
+            int m = kernel_values(component, x);
+            double schur = component.factor.schur_complement(b.head(m), 1+f->a, y.head(m));
+            log_det -= component.factor.log_det;
+            component.factor.append(y.head(m), schur);
+            log_det += component.factor.log_det;
+
+            component.members.push_back(position);
+            component_of.push_back(c);
+            index_of.push_back(m);
+        }
+
+        /**
+         * @brief Group points into connected components and factorize their kernel matrices in the order of arrival
+         * @param affected : Positions of the points, which belong to no component
+         */
+        void build_components(const vector<size_t> &affected)
+        {
+            vector<bool> visited(affected.size(), false);
+            for(size_t start = 0; start < affected.size(); ++start)
+            {
+                if(visited[start])
+                {
+                    continue;
+                }
+
+                //Breadth-first search over the points within the radius of each other
+                Component component;
+                visited[start] = true;
+                component.members.push_back(affected[start]);
+                for(size_t head = 0; head < component.members.size(); ++head)
+                {
+                    for(size_t j = 0; j < affected.size(); ++j)
+                    {
+                        if(!visited[j] && squared_distance(X[component.members[head]].data(), X[affected[j]].data(), f->dimension) <= f->radius*f->radius)
+                        {
+                            visited[j] = true;
+                            component.members.push_back(affected[j]);
+                        }
+                    }
+                }
+
+                sort(component.members.begin(), component.members.end(), [&](size_t i, size_t j)->bool{
+                    return ids[i] < ids[j];
+                });
+                vector<const double*> points;
+                for(size_t i : component.members)
+                {
+                    points.push_back(X[i].data());
+                }
+                if(!component.factor.factorize(kernel_matrix(points)))
+                {
+                    cout << "The sparse kernel matrix is not positive definite, the cutoff radius is too small!!!" << endl;
+                    exit(1);
+                }
+
+                log_det += component.factor.log_det;
+                for(size_t t = 0; t < component.members.size(); ++t)
+                {
+                    component_of[component.members[t]] = next_component;
+                    index_of[component.members[t]] = t;
+                }
+                components[next_component] = move(component);
+                ++next_component;
+            }
+        }
+
+        /**
+         * @brief Schur complement of a point with respect to the points of the set that arrived before it, from the factor of its component
+         * Since M is block diagonal over the components, only the points of its component that arrived before it contribute
+         * @param position : Position of the point
+         * @return log of the Schur complement
+         */
+        double log_schur_before(size_t position) const
+        {
+            const Component &component = components.at(component_of[position]);
+            size_t t = index_of[position];
+            return 2*log(component.factor.L(t,t));
+        }
+    };
+
+    //The solution set and A
+    SparseKernelSet S_set;
+    SparseKernelSet A_set;
+
+    /**
+     * @brief Constructor
+     * @param dimension : Vector dimension
+     * @param radius : Cutoff radius, see default_radius()
+     */
+    SparseGauVecSubFunc(int dimension, double radius)
+    {
+        this->dimension = dimension;
+        l = 1/(2*sqrt(dimension));
+        a = 1;
+        this->radius = radius;
+        S_set.f = this;
+        A_set.f = this;
+        store_A = false;
+        query = 0;
+    }
+
+    /**
+     * @brief Copy constructor, which points the sets to the copy
+     * @param other : Submodular function to be copied
+     */
+    SparseGauVecSubFunc(const SparseGauVecSubFunc &other) : SubmodularFunction(other), dimension(other.dimension), l(other.l), a(other.a), radius(other.radius), S_set(other.S_set), A_set(other.A_set)
+    {
+        S_set.f = this;
+        A_set.f = this;
+    }
+
+    /**
+     * @brief Cutoff radius beyond which the kernel value is below tolerance*a
+     * @param dimension : Vector dimension
+     * @param tolerance : Relative tolerance
+     * @return Cutoff radius
+     */
+    static double default_radius(int dimension, double tolerance = 1e-12)
+    {
+        double l = 1/(2*sqrt(dimension));
+        return l*sqrt(-2*log(tolerance));
+    }
+
+    /**
+     * @brief Kernel value, 0 beyond the cutoff radius
+     * @param squared_distance : Squared distance between two points
+     * @return Kernel value
+     */
+    double kernel(double squared_distance) const
+    {
+        if(squared_distance > radius*radius)
+        {
+            return 0;
+        }
+        return a*exp(-squared_distance/(2*l*l));
+    }
+
+    /**
+     * @brief Calculate the value of the solution set
+     * @param cur_solution : Current solution set
+     * @return Value of the solution set
+     */
+    double operator()(const vector<Point> &cur_solution)
+    {
+        if(cur_solution.empty())
+        {
+            return 0;
+        }
+
+        return S_set.log_det/2;
+    }
+
+    /**
+     * @brief Preallocate the storage of the solution set
+     * @param capacity : Maximum size of the solution set plus one
+     */
+    void reserve(size_t capacity)
+    {
+        S_set.X.reserve(capacity);
+        S_set.ids.reserve(capacity);
+        S_set.component_of.reserve(capacity);
+        S_set.index_of.reserve(capacity);
+    }
+
+    /**
+     * @brief Calculate the value after adding a point to the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that is added to the current solution set
+     * @param position : Position for the point to be added
+     * @return Value after adding point
+     */
+    double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        ++query;
+
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        return S_set.peek(cur_point.coordinates, position)/2;
+    }
+
+    /**
+     * @brief Upper bound of the marginal gain of appending a point, the value of the point alone
+     * @return Upper bound of the marginal gain
+     */
+    double gain_upper_bound(const vector<Point> &, const Point &)
+    {
+        return log(1+a)/2;
+    }
+
+    /**
+     * @brief Update the solution set
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     */
+    void update(vector<Point> &cur_solution, const Point &cur_point, size_t position)
+    {
+        if(position > cur_solution.size())
+        {
+            cout<<"The specified position is out of range!!!"<<endl;
+            exit(1);
+        }
+
+        if(position == cur_solution.size())
+        {
+            cur_solution.push_back(cur_point);
+        }
+        else
+        {
+            cur_solution[position] = cur_point;
+        }
+        S_set.update(cur_point.coordinates, cur_point.id, position);
+
+        if(store_A)
+        {
+            //Update A
+            A_set.update(cur_point.coordinates, cur_point.id, A_set.X.size());
+            fval_A = A_set.log_det/2;
+        }
+    }
+
+    /**
+     * @brief Create a new submodular function
+     * @return Reference to the new submodular function
+     */
+    SubmodularFunction& new_object()
+    {
+        SparseGauVecSubFunc *f = new SparseGauVecSubFunc(*this);
+        return *f;
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Value after adding point
+     */
+    double peek_delta_A(const Point &cur_point)
+    {
+        ++query;
+
+        if(!store_A)
+        {
+            cout << "Did not store A!!! \n";
+            exit(1);
+        }
+
+        return A_set.peek(cur_point.coordinates, A_set.X.size())/2 - fval_A;
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A \cap S, from the factor of its component
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Value after adding point
+     */
+    double peek_delta_A_cap_S(const vector<Point> &cur_solution, const Point &cur_point)
+    {
+        ++query;
+
+        for(size_t i = 0; i < cur_solution.size(); ++i)
+        {
+            if(cur_solution[i].id == cur_point.id)
+            {
+                return S_set.log_schur_before(i)/2;
+            }
+        }
+
+        cout << "This point dosen't in the solution!!! \n";
+        exit(1);
+    }
+
+    /**
+     * @brief Calculate the delta_value of every point of the solution set after adding it to A \cap S
+     * The factors of the components are kept in the order of arrival, so each delta_value is read from a diagonal entry
+     * @param cur_solution : Current solution set
+     * @param fdeltas : Output, fdeltas[i] is the delta_value of cur_solution[i]
+     */
+    void delta_A_cap_S_all(const vector<Point> &cur_solution, vector<double> &fdeltas)
+    {
+        query += cur_solution.size();
+
+        fdeltas.resize(cur_solution.size());
+        for(size_t i = 0; i < cur_solution.size(); ++i)
+        {
+            fdeltas[i] = S_set.log_schur_before(i)/2;
+        }
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Memory held to evaluate A
+     * @return Number of bytes of the coordinates of A, without its components
+     */
+    size_t bytes_A() const
+    {
+        return A_set.X.capacity()*sizeof(vector<double>) + A_set.X.size()*dimension*sizeof(double);
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~SparseGauVecSubFunc() {}
+};
+
+#endif // SPARSEGAUVECSUBFUNC_H
@@ -12,16 +12,22 @@
 
 using namespace std;
 
-class StreamingGreedy : public SubsetSelectionAlgorithm
+template<class F = SubmodularFunction>
+class StreamingGreedyT final : public SubsetSelectionAlgorithm
 {
 public:
+    //Submodular function with its concrete type, which hides SubsetSelectionAlgorithm::f
+    F &f;
+
+    //Contributions of the points of the solution set to A \cap S, reused across arrivals
+    vector<double> fdeltas_A_cap_S;
 
     /**
      * @brief Constructor
      * @param k: Cardinality constraint
      * @param f: Submodular function
      */
-    StreamingGreedy(size_t k, SubmodularFunction &f) : SubsetSelectionAlgorithm(k, f)
+    StreamingGreedyT(size_t k, F &f) : SubsetSelectionAlgorithm(k, f), f(static_cast<F&>(SubsetSelectionAlgorithm::f))
     {
 
     }
@@ -56,10 +62,12 @@ public:
             //Record the information of the replaced point
             double fdelta_min;//Value     
             size_t fdelta_min_position;//The position in the solution set
+            //Contributions of all points of the solution set, computed together
+            f.delta_A_cap_S_all(solution, fdeltas_A_cap_S);
             //Traverse the solution set
             for (size_t i = 0; i < solution.size(); ++i)
             {
-                double fdelta_temp = f.peek_delta_A_cap_S(solution, solution[i]);
+                double fdelta_temp = fdeltas_A_cap_S[i];
 
                 //Update information of the replaced point
                 if(i == 0)
@@ -74,11 +82,12 @@ public:
                 }
             }
 
-            double fdelta = f.peek(solution, cur_point, solution.size()) - fval;
+            SubmodularFunction::Evaluation eval;
+            double fdelta = f.peek(solution, cur_point, solution.size(), eval) - fval;
             if(fdelta >= 2*fdelta_min)
             {
                 //Perform the replacement
-                f.update(solution, cur_point, fdelta_min_position);
+                f.commit(solution, cur_point, fdelta_min_position, eval);
                 fval = f.operator()(solution);
             }           
         }
@@ -87,7 +96,9 @@ public:
     /**
      * @brief Destructor
      */
-    ~StreamingGreedy() {}
+    ~StreamingGreedyT() {}
 };
 
+typedef StreamingGreedyT<> StreamingGreedy;
+
 #endif
\ No newline at end of file
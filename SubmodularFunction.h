@@ -2,11 +2,13 @@
 #define SUBMODULARFUNCTION_H
 
 #include <memory>
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 #include <functional>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 
 #include "Point.h"
@@ -17,16 +19,33 @@ using namespace std;
 class SubmodularFunction {
 public:
 
-    //The set of all points that was added to the solution set
-    vector<Point> A;
-    //Whether the algorithm needs to store A
+    //Whether the algorithm needs to store A, the set of all points that was added to the solution set, which each function summarizes in its own way
     bool store_A;
     //Value of A
     double fval_A;
 
     //Query times of the submodular algorithm
     int query;
+
+    //Handle of an evaluation made by peek(), which commit() can install without recomputation
+    struct Evaluation
+    {
+        //Id of the evaluated point
+        size_t id = 0;
+        //Position where the point was evaluated
+        size_t position = 0;
+        //Identifies the intermediate results kept by the function, 0 if nothing is kept
+        size_t ticket = 0;
+        //Value after adding the point
+        double value = 0;
+    };
     
+    /**
+     * @brief Preallocate internal storage for solution sets of up to capacity-1 points, so that evaluating one more point does not allocate
+     * @param capacity : Maximum size of the solution set plus one
+     */
+    virtual void reserve(size_t) {}
+
     /**
      * @brief Calculate the value of the solution set
      * @param cur_solution : Current solution set
@@ -43,6 +62,53 @@ public:
      */
     virtual double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position)=0;
 
+    /**
+     * @brief Calculate the value after adding point to the solution set and return a handle of the evaluation
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     * @param eval : Output, handle that can be passed to commit()
+     * @return Value after adding point
+     */
+    virtual double peek(const vector<Point> &cur_solution, const Point &cur_point, size_t position, Evaluation &eval)
+    {
+        eval.id = cur_point.id;
+        eval.position = position;
+        eval.ticket = 0;
+        eval.value = peek(cur_solution, cur_point, position);
+
+        return eval.value;
+    }
+
+    /**
+     * @brief Upper bound of the marginal gain of appending a point to the solution set, much cheaper than peek() and not counted as a query
+     * The threshold algorithms reject the point without calling peek() when the bound is already below the threshold
+     * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Upper bound of the marginal gain, infinity if the function does not provide one
+     */
+    virtual double gain_upper_bound(const vector<Point> &, const Point &)
+    {
+        return INFINITY;
+    }
+
+    /**
+     * @brief Calculate the marginal gains of appending each of a block of candidates to the solution set
+     * @param cur_solution : Current solution set
+     * @param candidates : Points to be evaluated, each one separately
+     * @param fdeltas : Output, fdeltas[j] is the marginal gain of candidates[j]
+     */
+    virtual void peek_many(const vector<Point> &cur_solution, const vector<const Point*> &candidates, vector<double> &fdeltas)
+    {
+        double cur_fval = this->operator()(cur_solution);
+
+        fdeltas.resize(candidates.size());
+        for(size_t j = 0; j < candidates.size(); ++j)
+        {
+            fdeltas[j] = peek(cur_solution, *candidates[j], cur_solution.size()) - cur_fval;
+        }
+    }
+
     /**
      * @brief Update solution set
      * @param cur_solution : Current solution set
@@ -52,10 +118,28 @@ public:
     virtual void update(vector<Point> &cur_solution, const Point &cur_point, size_t position)=0;
 
     /**
-     * @brief Arrange the solution set in descending order of fdelta of data points
+     * @brief Update solution set, reusing the work of the peek() that returned eval when it is still valid
      * @param cur_solution : Current solution set
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @param position : Position to be added
+     * @param eval : Handle returned by peek() for cur_point
      */
-    virtual void sort_descend_fdelta(vector<Point> &cur_solution)=0;
+    virtual void commit(vector<Point> &cur_solution, const Point &cur_point, size_t position, const Evaluation &)
+    {
+        update(cur_solution, cur_point, position);
+    }
+
+    /**
+     * @brief Arrange the positions of the solution set in descending order of fdelta of data points, without moving the points
+     * @param fdeltas : Marginal gains of the points of the solution set, kept by the algorithm and indexed by positions
+     * @param order : Positions in the solution set, rearranged in place
+     */
+    virtual void sort_descend_fdelta(const vector<double> &fdeltas, vector<size_t> &order)
+    {
+        sort(order.begin(),order.end(),[&](size_t i,size_t j)->bool{
+            return fdeltas[i] > fdeltas[j];
+        });
+    }
 
     /**
      * @brief Create a new submodular function
@@ -78,6 +162,30 @@ public:
      */
     virtual double peek_delta_A_cap_S(const vector<Point> &cur_solution, const Point &cur_point)=0;
     
+    /**
+     * @brief Only used by FreeDisposal: Memory held to evaluate A
+     * @return Number of bytes, 0 if the function does not report it
+     */
+    virtual size_t bytes_A() const
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Only used by StreamingGreedy and FreeDisposal: Calculate the delta_value of every point of the solution set after adding it to A \cap S
+     * The points of A \cap S for a point are the points of the solution set that arrived before it, so these are the marginal gains in the order of arrival
+     * @param cur_solution : Current solution set
+     * @param fdeltas : Output, fdeltas[i] is the delta_value of cur_solution[i]
+     */
+    virtual void delta_A_cap_S_all(const vector<Point> &cur_solution, vector<double> &fdeltas)
+    {
+        fdeltas.resize(cur_solution.size());
+        for(size_t i = 0; i < cur_solution.size(); ++i)
+        {
+            fdeltas[i] = peek_delta_A_cap_S(cur_solution, cur_solution[i]);
+        }
+    }
+
     /**
      * @brief Destructor
      */
@@ -11,10 +11,14 @@
 #include <iostream>
 
 #include "SubmodularFunction.h"
+#include "CompactDataset.h"
 
 using namespace std;
 
 //The base class of various submodular algorithms
+//Each algorithm is a template on the type F of the submodular function, whose member f hides the one below with the type F.
+//With a final function class as F, the calls on every arrival are resolved at compile time and can be inlined,
+//while F = SubmodularFunction, the default, calls through the virtual interface.
 class SubsetSelectionAlgorithm
 {
 
@@ -31,6 +35,9 @@ public:
     //The value of the current solution set
     double fval;
 
+    //Number of exact evaluations skipped because an upper bound of the marginal gain was below the threshold
+    int skipped;
+
    /**
      * @brief Constructor
      * @param k: Cardinality constraint
@@ -39,6 +46,11 @@ public:
     SubsetSelectionAlgorithm(size_t k, SubmodularFunction &f) : k(k),f(f.new_object())
     {
         fval = 0;
+        skipped = 0;
+
+        //The solution set never holds more than k points, and one more is evaluated at a time
+        solution.reserve(k+1);
+        this->f.reserve(k+1);
     }
 
     /**
@@ -48,6 +60,20 @@ public:
      */
     virtual void run(const vector<Point> &Dataset, unsigned int iterations = 1) = 0;
 
+    /**
+     * @brief Run the submodular algorithm on a dataset stored in reduced precision, decoding one point at a time into the same point
+     * @param Dataset: Dataset
+     */
+    virtual void run_compact(const CompactDataset &Dataset)
+    {
+        Point cur_point;
+        for(size_t i = 0; i < Dataset.size(); ++i)
+        {
+            Dataset.decode(i, cur_point);
+            next(cur_point);
+        }
+    }
+
     /**
      * @brief Process streaming data
      * @param cur_point: The current point in the data flow
@@ -0,0 +1,155 @@
+#ifndef TOKENSTORE_H
+#define TOKENSTORE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief Words of a dataset of texts, interned to dense ids, with the ids of all texts in one CSR array.
+ * The ids of the words of text i are tokens[offsets[i]], ..., tokens[offsets[i+1]-1], and a point refers to them
+ * by a pointer, so the store must outlive the points and must not grow once they are created.
+ * After sort_words(), the ids follow the lexicographic order of the words, so that maps keyed by ids iterate
+ * in the same order as maps keyed by the words.
+ */
+
+class TokenStore
+{
+public:
+
+    //Words, indexed by id
+    vector<string> words;
+    //Id of each word
+    unordered_map<string,uint32_t> ids;
+
+    //CSR storage of the texts
+    vector<size_t> offsets;
+    vector<uint32_t> tokens;
+
+    /**
+     * @brief Constructor of an empty store
+     */
+    TokenStore()
+    {
+        offsets.push_back(0);
+    }
+
+    TokenStore(const TokenStore&) = delete;
+    TokenStore& operator=(const TokenStore&) = delete;
+
+    /**
+     * @brief Id of a word, which is added if it is new
+     * @param word : Word
+     * @return Id
+     */
+    uint32_t intern(const string &word)
+    {
+        auto it = ids.find(word);
+        if(it != ids.end())
+        {
+            return it->second;
+        }
+
+        uint32_t id = words.size();
+        ids.emplace(word, id);
+        words.push_back(word);
+        return id;
+    }
+
+    /**
+     * @brief Append a word to the last text
+     * @param word : Word
+     */
+    void add_word(const string &word)
+    {
+        tokens.push_back(intern(word));
+    }
+
+    /**
+     * @brief End the last text, the words added next belong to a new text
+     */
+    void end_text()
+    {
+        offsets.push_back(tokens.size());
+    }
+
+    /**
+     * @brief Renumber the words in lexicographic order
+     */
+    void sort_words()
+    {
+        vector<uint32_t> order(words.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j)->bool{
+            return words[i] < words[j];
+        });
+
+        vector<uint32_t> new_id(words.size());
+        vector<string> sorted_words(words.size());
+        for(uint32_t i = 0; i < order.size(); ++i)
+        {
+            new_id[order[i]] = i;
+            sorted_words[i] = move(words[order[i]]);
+        }
+        words.swap(sorted_words);
+
+        for(auto &pair : ids)
+        {
+            pair.second = new_id[pair.second];
+        }
+        for(auto &token : tokens)
+        {
+            token = new_id[token];
+        }
+    }
+
+    /**
+     * @brief Number of texts
+     * @return Number of texts
+     */
+    size_t size() const
+    {
+        return offsets.size() - 1;
+    }
+
+    /**
+     * @brief Ids of the words of a text
+     * @param i : Index of the text
+     * @return Pointer to the first id, followed by the other ones
+     */
+    const uint32_t* text(size_t i) const
+    {
+        return tokens.data() + offsets[i];
+    }
+
+    /**
+     * @brief Number of words of a text
+     * @param i : Index of the text
+     * @return Number of words
+     */
+    size_t text_size(size_t i) const
+    {
+        return offsets[i+1] - offsets[i];
+    }
+
+    /**
+     * @brief Memory of the CSR arrays and of the words
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        size_t bytes = offsets.capacity()*sizeof(size_t) + tokens.capacity()*sizeof(uint32_t) + words.capacity()*sizeof(string);
+        for(auto &word : words)
+        {
+            bytes += word.capacity();
+        }
+        return bytes;
+    }
+};
+
+#endif // TOKENSTORE_H
@@ -8,6 +8,10 @@
 #include <cassert>
 #include <iostream>
 #include <map>
+#include <utility>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
 
 #include "SubmodularFunction.h"
 #include "Point.h"
@@ -18,12 +22,25 @@ using namespace std;
  * @brief This submodular function is applicable to the following dataset: “Twitter”
  */
 
-class TweetTexSubFunc : public SubmodularFunction
+class TweetTexSubFunc final : public SubmodularFunction
 {  
 public:
 
-    //Count the forwarding times of each word in A
-    map<string,double> word_to_retweets_A;
+    //Count the forwarding times of each word in the solution set and in A, indexed by the ids of the words
+    vector<double> retweets_S;
+    vector<double> retweets_A;
+    //Value of the solution set, kept up to date by update()
+    double fval;
+
+    //Counts changed by a peek, with their previous values, restored once it is scored
+    //It is empty between evaluations, since every peek restores the counts before returning
+    vector<pair<uint32_t,double>> undo;
+    //Counts of the words of the points of A \cap S, all 0 between evaluations, and positions of the solution set in the order of arrival
+    vector<double> retweets_prefix;
+    vector<size_t> by_id;
+
+    //Keep the peek() of the base class that returns an evaluation handle visible next to the override below
+    using SubmodularFunction::peek;
 
     /**
      * @brief Constructor
@@ -32,6 +49,8 @@ public:
     {
         store_A = false;
         query = 0;
+        fval = 0;
+        fval_A = 0;
     }
 
     /**
@@ -46,34 +65,96 @@ public:
             return 0;
         }
 
+        return fval;
+    }
+
+    /**
+     * @brief Calculate the value of any set of points from scratch
+     * @param points : Set of points
+     * @return Value of the set
+     */
+    static double value(const vector<Point> &points)
+    {
         //Count the forwarding times of each word
-        map<string,double> word_to_retweets;
-        for(auto p : cur_solution)
+        map<uint32_t,double> word_to_retweets;
+        for(auto &p : points)
         {
-            for(auto word : p.words)
+            for(uint32_t word : p.word_ids())
             {
-                if(word_to_retweets.count(word))
-                {
-                    word_to_retweets[word] += p.retweets;
-                }
-                else
-                {
-                    word_to_retweets[word] = p.retweets;
-                }   
+                word_to_retweets[word] += p.retweets;
             }
         }
 
         //Accumulate
         double retweets_all = 0;
-        for(auto pair : word_to_retweets)
+        for(auto &pair : word_to_retweets)
         {
             retweets_all += sqrt(pair.second);
         }
         return retweets_all;
     }
 
+    /**
+     * @brief Make room in the counts for all the words of the dataset of a point
+     * @param cur_point : Point of the dataset
+     */
+    void reserve_words(const Point &cur_point)
+    {
+        size_t words = cur_point.token_store ? cur_point.token_store->words.size() : 0;
+        if(retweets_S.size() < words)
+        {
+            retweets_S.resize(words, 0);
+        }
+        if(retweets_prefix.size() < words)
+        {
+            retweets_prefix.resize(words, 0);
+        }
+        if(store_A && retweets_A.size() < words)
+        {
+            retweets_A.resize(words, 0);
+        }
+    }
+
+    /**
+     * @brief Add or remove the retweets of a point to or from the counts of its words
+     * @param retweets : Counts of the words
+     * @param cur_point : Point
+     * @param sign : 1 to add the point, -1 to remove it
+     * @param keep : Whether the change is kept, otherwise the previous counts are recorded for restore()
+     * @return Increase of the sum of the square roots of the counts
+     */
+    double change_words(vector<double> &retweets, const Point &cur_point, double sign, bool keep)
+    {
+        double delta = 0;
+        for(uint32_t word : cur_point.word_ids())
+        {
+            double &count = retweets[word];
+            if(!keep)
+            {
+                undo.emplace_back(word, count);
+            }
+            double after = max(0.0, count + sign*cur_point.retweets);
+            delta += sqrt(after) - sqrt(count);
+            count = after;
+        }
+        return delta;
+    }
+
+    /**
+     * @brief Restore the counts changed by change_words() since the last restore
+     * @param retweets : Counts of the words
+     */
+    void restore(vector<double> &retweets)
+    {
+        for(auto it = undo.rbegin(); it != undo.rend(); ++it)
+        {
+            retweets[it->first] = it->second;
+        }
+        undo.clear();
+    }
+
    /**
-     * @brief Calculate the value after adding point to the solution set
+     * @brief Calculate the value after adding point to the solution set, only the counts of its words and those of the replaced point change
      * @param cur_solution : Current solution set
      * @param cur_point : Point that needs to be added to the current solution set
      * @param position : Position to be added
@@ -89,25 +170,35 @@ public:
             exit(1);
         }
 
-        if(cur_solution.size() == 0)
-        {
-            return this->operator()({cur_point});
-        }
+        reserve_words(cur_point);
+        assert(undo.empty());
 
-        vector<Point> tmp_solution(cur_solution);
-        
-        if(position == cur_solution.size())
-        {
-            //Append
-            tmp_solution.push_back(cur_point);              
-        }
-        else
+        double delta = 0;
+        if(position < cur_solution.size())
         {
             //Replace
-            tmp_solution[position] = cur_point;
+            delta += change_words(retweets_S, cur_solution[position], -1, false);
         }
+        delta += change_words(retweets_S, cur_point, 1, false);
+        restore(retweets_S);
 
-        return this->operator()(tmp_solution);
+        return fval + delta;
+    }
+
+    /**
+     * @brief Marginal gain of appending a point, which bounds itself: the exact increment of the counts of its words in the solution set,
+     * computed in O(|words|) in the counts and the undo log without allocating
+     * @param cur_point : Point that needs to be added to the current solution set
+     * @return Marginal gain, rounded as peek() - fval so that it is never below the gain measured by peek()
+     */
+    double gain_upper_bound(const vector<Point> &, const Point &cur_point)
+    {
+        reserve_words(cur_point);
+        assert(undo.empty());
+        double delta = change_words(retweets_S, cur_point, 1, false);
+        restore(retweets_S);
+
+        return (fval + delta) - fval;
     }
 
     /**
@@ -124,56 +215,29 @@ public:
             exit(1);
         }
 
-        
+        reserve_words(cur_point);
+
         if(position == cur_solution.size())
         {
             //Append
+            fval += change_words(retweets_S, cur_point, 1, true);
             cur_solution.push_back(cur_point);
         }
         else
         {
             //Replace
+            fval += change_words(retweets_S, cur_solution[position], -1, true);
+            fval += change_words(retweets_S, cur_point, 1, true);
             cur_solution[position] = cur_point;
         }
 
         if(store_A)
         {
-            //Update A
-            A.push_back(cur_point);
-
             //Update fval_A
-            for(auto word : cur_point.words)
-            {
-                if(word_to_retweets_A.count(word))
-                {
-                    word_to_retweets_A[word] += cur_point.retweets;
-                }
-                else
-                {
-                    word_to_retweets_A[word] = cur_point.retweets;
-                }   
-            }
-
-            double retweets_all_A = 0;
-            for(auto pair : word_to_retweets_A)
-            {
-                retweets_all_A += sqrt(pair.second);
-            }
-            fval_A = retweets_all_A;
+            fval_A += change_words(retweets_A, cur_point, 1, true);
         }
     }
 
-    /**
-     * @brief Arrange the solution set in descending order of fdelta of data points
-     * @param cur_solution : Current solution set
-     */
-    void sort_descend_fdelta(vector<Point> &cur_solution)
-    {
-        sort(cur_solution.begin(),cur_solution.end(),[&](const Point &a,const Point &b)->bool{
-            return a.fdelta > b.fdelta;
-        });
-    }
-
     /**
      * @brief Create a new submodular function
      * @return Reference to new submodular function
@@ -185,7 +249,7 @@ public:
     }
 
      /**
-     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A
+     * @brief Only used by FreeDisposal: Calculate the delta_value after adding point to A, from the counts of the words in A
      * @param cur_point : Point that needs to be added to the current solution set
      * @return Value after adding point
      */
@@ -199,31 +263,16 @@ public:
             exit(1);
         }
 
-        map<string,double> temp_word_to_retweets_A(word_to_retweets_A);
-
-        for(auto word : cur_point.words)
-        {
-            if(temp_word_to_retweets_A.count(word))
-            {
-                temp_word_to_retweets_A[word] += cur_point.retweets;
-            }
-            else
-            {
-                temp_word_to_retweets_A[word] = cur_point.retweets;
-            }   
-        }
-
-        double retweets_all = 0;
-        for(auto pair : temp_word_to_retweets_A)
-        {
-            retweets_all += sqrt(pair.second);
-        }
+        reserve_words(cur_point);
+        assert(undo.empty());
+        double delta = change_words(retweets_A, cur_point, 1, false);
+        restore(retweets_A);
 
-        return retweets_all - fval_A;
+        return delta;
     }
 
     /**
-     * @brief Calculate the delta_value after adding point to A \cap S
+     * @brief Calculate the delta_value after adding point to A \cap S, from the counts of the words of the points of the solution set that arrived before it
      * @param cur_solution : Current solution set
      * @param cur_point : Point that needs to be added to the current solution set
      * @return Value after adding point
@@ -232,22 +281,65 @@ public:
     {
         ++query;
 
-        //Find points in A \cap S
-        vector<Point> A_cap_S;//The positions in S of points in A \cap S
-        int cur_id = cur_point.id;//The position of cur_point in A
-        for(auto p : cur_solution)
+        reserve_words(cur_point);
+        assert(undo.empty());
+
+        //Count the forwarding times of each word of the points in A \cap S
+        size_t cur_id = cur_point.id;//The position of cur_point in A
+        for(const auto &p : cur_solution)
         {
-            if(p.id<cur_id)
+            if(p.id < cur_id)
             {
-                A_cap_S.push_back(p);
+                change_words(retweets_prefix, p, 1, false);
             }
         }
 
-        double before = this->operator()(A_cap_S);
-        A_cap_S.push_back(cur_point);
-        double after = this->operator()(A_cap_S);
+        double fdelta = change_words(retweets_prefix, cur_point, 1, false);
+        restore(retweets_prefix);
+
+        return fdelta;
+    }
+
+    /**
+     * @brief Calculate the delta_value of every point of the solution set after adding it to A \cap S, in one pass in the order of arrival
+     * Each point adds its retweets to the counts of its words left by the points before it, and gains the increase of their square roots
+     * @param cur_solution : Current solution set
+     * @param fdeltas : Output, fdeltas[i] is the delta_value of cur_solution[i]
+     */
+    void delta_A_cap_S_all(const vector<Point> &cur_solution, vector<double> &fdeltas)
+    {
+        query += cur_solution.size();
 
-        return after-before;
+        fdeltas.resize(cur_solution.size());
+        if(cur_solution.empty())
+        {
+            return;
+        }
+        reserve_words(cur_solution[0]);
+        assert(undo.empty());
+
+        //Positions of the solution set in the order of arrival
+        by_id.resize(cur_solution.size());
+        iota(by_id.begin(), by_id.end(), 0);
+        sort(by_id.begin(), by_id.end(), [&](size_t i, size_t j)->bool{
+            return cur_solution[i].id < cur_solution[j].id;
+        });
+
+        //Count the forwarding times of each word of the points so far, and restore the counts to 0 at the end
+        for(size_t i : by_id)
+        {
+            fdeltas[i] = change_words(retweets_prefix, cur_solution[i], 1, false);
+        }
+        restore(retweets_prefix);
+    }
+
+    /**
+     * @brief Only used by FreeDisposal: Memory held to evaluate A
+     * @return Number of bytes of the counts of the words in A
+     */
+    size_t bytes_A() const
+    {
+        return retweets_A.capacity()*sizeof(double);
     }
 
     /**
@@ -0,0 +1,160 @@
+#ifndef VECTORSTORE_H
+#define VECTORSTORE_H
+
+#include <vector>
+#include <iostream>
+#include <sys/mman.h>
+#include <Eigen/Core>
+
+using namespace std;
+using namespace Eigen;
+
+/**
+ * @brief Coordinates of a dataset of numerical vectors in one aligned buffer, point-major, so that a scan of the dataset is sequential.
+ * The coordinates of vector i are values[i*dimension], ..., values[(i+1)*dimension-1], and a point refers to them
+ * by a pointer, so the store must outlive the points and must not grow once they are created.
+ * The coordinates are either held in values or, when the store maps a binary cache of the dataset, read in place
+ * from the mapped file.
+ */
+
+class VectorStore
+{
+public:
+
+    //Dimension of the vectors
+    size_t dimension;
+    //Coordinates of all vectors
+    vector<double, aligned_allocator<double>> values;
+
+    //The mapped file, its coordinates and their number of vectors, or nullptr when the coordinates are in values
+    void *mapping;
+    size_t mapping_bytes;
+    const double *mapped_values;
+    size_t mapped_size;
+
+    /**
+     * @brief Constructor of an empty store
+     * @param dimension : Dimension of the vectors
+     */
+    VectorStore(size_t dimension = 0)
+    {
+        this->dimension = dimension;
+        mapping = nullptr;
+        mapping_bytes = 0;
+        mapped_values = nullptr;
+        mapped_size = 0;
+    }
+
+    VectorStore(const VectorStore&) = delete;
+    VectorStore& operator=(const VectorStore&) = delete;
+
+    /**
+     * @brief Destructor
+     */
+    ~VectorStore()
+    {
+        if(mapping)
+        {
+            munmap(mapping, mapping_bytes);
+        }
+    }
+
+    /**
+     * @brief Take over a mapped file, whose coordinates are then read in place
+     * @param mapping : The mapped file, unmapped by the store
+     * @param mapping_bytes : Size of the mapping
+     * @param data : Coordinates of the vectors in the mapping
+     * @param n : Number of vectors
+     */
+    void adopt_mapping(void *mapping, size_t mapping_bytes, const double *data, size_t n)
+    {
+        if(this->mapping || !values.empty())
+        {
+            cout << "A VectorStore can only map a file when it is empty!!!" << endl;
+            exit(1);
+        }
+        this->mapping = mapping;
+        this->mapping_bytes = mapping_bytes;
+        mapped_values = data;
+        mapped_size = n;
+    }
+
+    /**
+     * @brief Reserve room for a number of vectors
+     * @param n : Number of vectors
+     */
+    void reserve(size_t n)
+    {
+        values.reserve(n*dimension);
+    }
+
+    /**
+     * @brief Append a coordinate, the coordinates of a vector being appended one after another
+     * @param x : Coordinate
+     */
+    void add_coordinate(double x)
+    {
+        values.push_back(x);
+    }
+
+    /**
+     * @brief Append a vector
+     * @param x : Its coordinates, dimension of them
+     */
+    void add_vector(const double *x)
+    {
+        values.insert(values.end(), x, x + dimension);
+    }
+
+    /**
+     * @brief Number of vectors
+     * @return Number of vectors
+     */
+    size_t size() const
+    {
+        if(mapped_values)
+        {
+            return mapped_size;
+        }
+        return dimension == 0 ? 0 : values.size()/dimension;
+    }
+
+    /**
+     * @brief Coordinates of all vectors
+     * @return Pointer to the first coordinate of the first vector
+     */
+    const double* data() const
+    {
+        return mapped_values ? mapped_values : values.data();
+    }
+
+    /**
+     * @brief Coordinates of a vector
+     * @param i : Index of the vector
+     * @return Pointer to its first coordinate, followed by the other ones
+     */
+    const double* vector_at(size_t i) const
+    {
+        return data() + i*dimension;
+    }
+
+    /**
+     * @brief All vectors as the rows of a matrix, without copying them
+     * @return Row-major map of size() x dimension
+     */
+    Map<const Matrix<double,Dynamic,Dynamic,RowMajor>> matrix() const
+    {
+        return Map<const Matrix<double,Dynamic,Dynamic,RowMajor>>(data(), size(), dimension);
+    }
+
+    /**
+     * @brief Memory of the coordinates allocated on the heap, a mapped file being backed by the page cache instead
+     * @return Number of bytes
+     */
+    size_t bytes() const
+    {
+        return values.capacity()*sizeof(double);
+    }
+};
+
+#endif // VECTORSTORE_H
@@ -6,12 +6,19 @@
 #include <map>
 #include <algorithm>
 #include <list>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <optional>
 
 #include "Point.h"
 #include "IOUtil.h"
 #include "GauVecSubFunc.h"
 #include "LapVecSubFunc.h"
 #include "TweetTexSubFunc.h"
+#include "FeatureVecSubFunc.h"
+#include "SparseGauVecSubFunc.h"
 #include "Greedy.h"
 #include "IndependentSetImprovement.h"
 #include "StreamingGreedy.h"
@@ -22,32 +29,127 @@
 
 using namespace std;
 
+#ifdef COUNT_ALLOCATIONS
+//Number of calls of operator new, counted when building with -DCOUNT_ALLOCATIONS to check that a path does not allocate
+atomic<size_t> allocation_count(0);
+
+void* operator new(size_t bytes)
+{
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    void *p = malloc(bytes);
+    if(!p)
+    {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+#endif
+
+/**
+ * @brief Number of allocations so far
+ * @return Number of calls of operator new, or 0 if they are not counted
+ */
+size_t allocations()
+{
+#ifdef COUNT_ALLOCATIONS
+    return allocation_count.load();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Time the distances between consecutive points of a dataset with the allocation-free primitive and with operator-, and count their allocations
+ * @param Dataset: The dataset of numerical vectors
+ * @param rounds: Number of passes over the dataset
+*/
+void benchmark_distances(const vector<Point> &Dataset, size_t rounds = 100)
+{
+    if(Dataset.size() < 2)
+    {
+        return;
+    }
+
+    double sum = 0;
+    size_t before = allocations();
+    auto start = chrono::steady_clock::now();
+    for(size_t round = 0; round < rounds; ++round)
+    {
+        for(size_t i = 0; i + 1 < Dataset.size(); ++i)
+        {
+            sum += Dataset[i].squared_distance_to(Dataset[i+1]);
+        }
+    }
+    chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+    size_t primitive_allocations = allocations() - before;
+    cout << "Point primitives:\t squared_distance_to\t runtime:\t" << runtime_seconds.count() << "\t allocations:\t" << primitive_allocations << "\t sum:\t" << sum << endl;
+
+    sum = 0;
+    before = allocations();
+    start = chrono::steady_clock::now();
+    for(size_t round = 0; round < rounds; ++round)
+    {
+        for(size_t i = 0; i + 1 < Dataset.size(); ++i)
+        {
+            double length = (Dataset[i] - Dataset[i+1]).length();
+            sum += length*length;
+        }
+    }
+    runtime_seconds = chrono::steady_clock::now() - start;
+    cout << "Point primitives:\t operator- and length\t runtime:\t" << runtime_seconds.count() << "\t allocations:\t" << allocations() - before << "\t sum:\t" << sum << endl;
+
+#ifndef COUNT_ALLOCATIONS
+    cout << "Point primitives:\t allocations are only counted when building with -DCOUNT_ALLOCATIONS" << endl;
+#endif
+    cout << endl;
+}
+
 /**
  * @brief Evaluate the performance of an algorithm on a dataset
  * @param alg: The algorithm to be evaluated
  * @param Dataset: The dataset where the algorithm to be evaluated 
- * @return Tuple: function value of solution set, running time, size of the solution set, total oracles
+ * @param Compact: The coordinates of the dataset in reduced precision, which the algorithm reads instead if not null
+ * @return Tuple: function value of solution set, running time, size of the solution set, total oracles, skipped oracles
 */
-auto evaluate_algorithm(SubsetSelectionAlgorithm &alg, const vector<Point> &Dataset)
+auto evaluate_algorithm(SubsetSelectionAlgorithm &alg, const vector<Point> &Dataset, const CompactDataset *Compact = nullptr)
 {
     auto start = chrono::steady_clock::now();
-    alg.run(Dataset);
+    if(Compact)
+    {
+        alg.run_compact(*Compact);
+    }
+    else
+    {
+        alg.run(Dataset);
+    }
     auto end = chrono::steady_clock::now();
     chrono::duration<double> runtime_seconds = end - start;
     double fval = alg.fval;
     int query = alg.f.query;
-    return make_tuple(fval, runtime_seconds.count(),alg.solution.size(),query);
+    return make_tuple(fval, runtime_seconds.count(),alg.solution.size(),query,alg.skipped);
 }
 
 /**
  * @brief Compare different algorithms on a dataset to maximize a submodular function
- * @param f: The submodular function to be maximized
+ * @param f: The submodular function to be maximized, whose type F is passed on to the algorithms so that they call it without virtual dispatch
  * @param Dataset: The dataset where different algorithms to be compared
+ * @param Compact: The coordinates of the dataset in reduced precision, which the algorithms read instead if not null, decoding one point at a time
 */
-void run_algorithms(SubmodularFunction &f, const vector<Point> &Dataset)
+template<class F>
+void run_algorithms(F &f, const vector<Point> &Dataset, const CompactDataset *Compact = nullptr)
 {
-    //Record the results of each algorithm: function value of solution set, running time, size of solution set, total oracles
-    tuple<double, double,size_t,int> res;  
+    //Record the results of each algorithm: function value of solution set, running time, size of solution set, total oracles, skipped oracles
+    tuple<double, double,size_t,int,int> res;  
 
     //Output path of algorithm result 
     vector<string> outfiles = {
@@ -57,6 +159,7 @@ void run_algorithms(SubmodularFunction &f, const vector<Point> &Dataset)
     ofstream outfile;
     
     //Cardinality constraint
+    //The fixed-size submodular functions hold at most max_k points
     vector<size_t> ks = {10,20,30,40,50};
     // vector<size_t> ks = {30};
     for(auto k : ks)
@@ -65,20 +168,20 @@ void run_algorithms(SubmodularFunction &f, const vector<Point> &Dataset)
         outfile.open(outfiles[0], ios::out|ios::app);
 
         // Greedy
-        Greedy my_Greedy(k, f);
-        res = evaluate_algorithm(my_Greedy, Dataset);
+        GreedyT<F> my_Greedy(k, f);
+        res = evaluate_algorithm(my_Greedy, Dataset, Compact);
         cout << "Greedy:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) << "\t queries:\t"<< get<3>(res)<< endl;
         outfile << "Greedy:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) << "\t queries:\t"<< get<3>(res)<< endl;    
 
         // IndependentSetImprovement
-        IndependentSetImprovement my_IndependentSetImprovement(k, f);
-        res = evaluate_algorithm(my_IndependentSetImprovement, Dataset);
+        IndependentSetImprovementT<F> my_IndependentSetImprovement(k, f);
+        res = evaluate_algorithm(my_IndependentSetImprovement, Dataset, Compact);
         cout << "IndependentSetImprovement:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
         outfile << "IndependentSetImprovement:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;     
 
         // StreamingGreedy
-        StreamingGreedy my_StreamingGreedy(k, f);
-        res = evaluate_algorithm(my_StreamingGreedy, Dataset);
+        StreamingGreedyT<F> my_StreamingGreedy(k, f);
+        res = evaluate_algorithm(my_StreamingGreedy, Dataset, Compact);
         cout << "StreamingGreedy:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
         outfile << "StreamingGreedy:\t Selecting " << k << " points" << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl; 
 
@@ -86,36 +189,36 @@ void run_algorithms(SubmodularFunction &f, const vector<Point> &Dataset)
         auto c_Preemption = {1.0};
         for(auto c: c_Preemption)
         {
-            Preemption my_Preemption(k, f, c);
-            res = evaluate_algorithm(my_Preemption, Dataset);
+            PreemptionT<F> my_Preemption(k, f, c);
+            res = evaluate_algorithm(my_Preemption, Dataset, Compact);
             cout << "Preemption:\t Selecting " << k << " points with c = " << c << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
             outfile << "Preemption:\t Selecting " << k << " points with c = " << c << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
         }
         
         //FreeDisposal
-        FreeDisposal my_FreeDisposal(k, f);
-        res = evaluate_algorithm(my_FreeDisposal, Dataset);
-        cout << "FreeDisposal:\t Selecting " << k <<"->"<<get<2>(res)<< " points \t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
-        outfile << "FreeDisposal:\t Selecting " << k <<"->"<<get<2>(res)<< " points \t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<< endl;
+        FreeDisposalT<F> my_FreeDisposal(k, f);
+        res = evaluate_algorithm(my_FreeDisposal, Dataset, Compact);
+        cout << "FreeDisposal:\t Selecting " << k <<"->"<<get<2>(res)<< " points \t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<<"\t A bytes:\t"<< my_FreeDisposal.f.bytes_A()<< endl;
+        outfile << "FreeDisposal:\t Selecting " << k <<"->"<<get<2>(res)<< " points \t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) <<"\t queries:\t"<< get<3>(res)<<"\t A bytes:\t"<< my_FreeDisposal.f.bytes_A()<< endl;
    
         //OnlineAdaptive
         auto r_OnlineAdaptive = {1.0, 3.0, 5.0, 7.0, 9.0, 1.0*k};
         for(auto r: r_OnlineAdaptive)
         {
-            OnlineAdaptive my_OnlineAdaptive(k, f, r);
-            res = evaluate_algorithm(my_OnlineAdaptive, Dataset);
-            cout << "OnlineAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res)<< endl;
-            outfile << "OnlineAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res)<< endl;   
+            OnlineAdaptiveT<F> my_OnlineAdaptive(k, f, r);
+            res = evaluate_algorithm(my_OnlineAdaptive, Dataset, Compact);
+            cout << "OnlineAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res) <<"\t skipped:\t"<< get<4>(res)<< endl;
+            outfile << "OnlineAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res) <<"\t skipped:\t"<< get<4>(res)<< endl;   
         }       
 
         //OnlineNonAdaptive
         auto r_OnlineNonAdaptive = {1.0, 3.0, 5.0, 7.0, 9.0};
         for(auto r: r_OnlineNonAdaptive)
         {
-            OnlineNonAdaptive my_OnlineNonAdaptive(k, f, r);
-            res = evaluate_algorithm(my_OnlineNonAdaptive, Dataset);
-            cout << "OnlineNonAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res)<< endl;
-            outfile << "OnlineNonAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res)<< endl;   
+            OnlineNonAdaptiveT<F> my_OnlineNonAdaptive(k, f, r);
+            res = evaluate_algorithm(my_OnlineNonAdaptive, Dataset, Compact);
+            cout << "OnlineNonAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res) <<"\t skipped:\t"<< get<4>(res)<< endl;
+            outfile << "OnlineNonAdaptive:\t Selecting " << k <<"->"<<get<2>(res)<< " points with r = " << r << "\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res)  <<"\t queries:\t"<< get<3>(res) <<"\t skipped:\t"<< get<4>(res)<< endl;   
         }  
 
 
@@ -130,6 +233,357 @@ void run_algorithms(SubmodularFunction &f, const vector<Point> &Dataset)
     }
 }
 
+/**
+ * @brief Calculate the value of a solution set from the double-precision coordinates of its points
+ * @param f: The submodular function, which has not been updated
+ * @param solution: The solution set, whose ids are positions in Dataset
+ * @param Dataset: The dataset in double precision
+ * @return Function value of the solution set
+*/
+double evaluate_solution(SubmodularFunction &f, const vector<Point> &solution, const vector<Point> &Dataset)
+{
+    SubmodularFunction &g = f.new_object();
+    vector<Point> exact;
+    for(auto &p : solution)
+    {
+        g.update(exact, Dataset[p.id], exact.size());
+    }
+    double fval = g.operator()(exact);
+    delete &g;
+    return fval;
+}
+
+/**
+ * @brief Report the quality of the reduced-precision storage modes against the double path, with OnlineAdaptive
+ * @param f: The submodular function
+ * @param Dataset: The dataset in double precision
+ * @param k: Cardinality constraint
+*/
+template<class F>
+void report_precisions(F &f, const vector<Point> &Dataset, size_t k)
+{
+    double r = 5.0;
+    size_t float64_bytes = Dataset.size()*Dataset[0].dimension*sizeof(double);
+
+    //The double path
+    OnlineAdaptiveT<F> reference(k, f, r);
+    auto res = evaluate_algorithm(reference, Dataset);
+    cout << "OnlineAdaptive:	 Selecting " << k << " points with r = " << r << ", float64 coordinates	 bytes:	" << float64_bytes << "	 fval:	" << get<0>(res) << "	 runtime:	" << get<1>(res) << endl;
+
+    //Coordinates stored in reduced precision, the solution being evaluated with the original coordinates
+    for(auto precision : {CompactDataset::Float32, CompactDataset::BFloat16, CompactDataset::Int8})
+    {
+        CompactDataset Compact(Dataset, precision);
+        OnlineAdaptiveT<F> alg(k, f, r);
+        auto start = chrono::steady_clock::now();
+        alg.run_compact(Compact);
+        chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+        double fval = evaluate_solution(f, alg.solution, Dataset);
+        cout << "OnlineAdaptive:	 Selecting " << k << " points with r = " << r << ", " << CompactDataset::name(precision) << " coordinates	 bytes:	" << Compact.bytes() << "	 fval:	" << fval << "	 delta:	" << fval - get<0>(res) << "	 runtime:	" << runtime_seconds.count() << endl;
+    }
+
+    cout << endl;
+}
+
+/**
+ * @brief Report the quality of the approximate log-determinant of FeatureVecSubFunc against the exact function, with OnlineAdaptive
+ * @param f: The exact submodular function
+ * @param kernel: Kernel of the exact submodular function
+ * @param Dataset: The dataset
+ * @param k: Cardinality constraint
+*/
+template<class F>
+void report_approximation(F &f, KernelRow::Kernel kernel, const vector<Point> &Dataset, size_t k)
+{
+    double r = 5.0;
+    size_t dim = Dataset[0].dimension;
+
+    //The exact function
+    OnlineAdaptiveT<F> reference(k, f, r);
+    auto res = evaluate_algorithm(reference, Dataset);
+    cout << "OnlineAdaptive:\t Selecting " << k << " points with r = " << r << ", exact\t fval:\t" << get<0>(res) << "\t runtime:\t" << get<1>(res) << endl;
+
+    //Landmarks of the Nystrom features are sampled uniformly from the dataset
+    vector<size_t> shuffled(Dataset.size());
+    iota(shuffled.begin(), shuffled.end(), 0);
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(0));
+
+    //The solution of the approximate function is also evaluated with the exact function
+    for(int D : {16, 64, 256})
+    {
+        for(auto features : {FeatureVecSubFunc::RandomFourier, FeatureVecSubFunc::Nystrom})
+        {
+            vector<Point> landmarks;
+            for(size_t i = 0; i < min<size_t>(D, Dataset.size()); ++i)
+            {
+                landmarks.push_back(Dataset[shuffled[i]]);
+            }
+            FeatureVecSubFunc g = (features == FeatureVecSubFunc::RandomFourier) ? FeatureVecSubFunc(kernel, dim, D) : FeatureVecSubFunc(kernel, dim, landmarks);
+
+            OnlineAdaptiveT<FeatureVecSubFunc> alg(k, g, r);
+            auto res_g = evaluate_algorithm(alg, Dataset);
+            double fval = evaluate_solution(f, alg.solution, Dataset);
+            cout << "OnlineAdaptive:\t Selecting " << k << " points with r = " << r << ", " << g.D << (features == FeatureVecSubFunc::RandomFourier ? " random Fourier features" : " Nystrom features")
+                << "\t approximate fval:\t" << get<0>(res_g) << "\t exact fval:\t" << fval << "\t delta:\t" << fval - get<0>(res) << "\t runtime:\t" << get<1>(res_g) << endl;
+        }
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Run every path of a kernel submodular function that must not allocate: appending, evaluating and committing a replacement,
+ * the bound of the gains, the gains of a block of candidates and the gains in A \cap S, one at a time and all at once. Built with -DEIGEN_RUNTIME_NO_MALLOC, an allocation by Eigen in these paths fails an assertion
+ * @param f: The submodular function, which is not modified
+ * @param Dataset: The dataset
+ * @param k: Cardinality constraint
+*/
+template<class F>
+void check_no_malloc(F &f, const vector<Point> &Dataset, size_t k)
+{
+#ifndef EIGEN_RUNTIME_NO_MALLOC
+    cout << "check_no_malloc needs main.cpp to be built with -DEIGEN_RUNTIME_NO_MALLOC!!!" << endl;
+    exit(1);
+#endif
+
+    F g(f);
+    g.reserve(k+1);
+    vector<Point> solution;
+    solution.reserve(k);
+    vector<double> fdeltas;
+    fdeltas.reserve(k);
+    vector<const Point*> candidates;
+    vector<double> candidate_fdeltas;
+    for(size_t i = 0; i < Dataset.size(); ++i)
+    {
+        const Point &p = Dataset[i];
+        g.gain_upper_bound(solution, p);
+        SubmodularFunction::Evaluation eval;
+        if(solution.size() < k)
+        {
+            g.peek(solution, p, solution.size(), eval);
+            g.commit(solution, p, solution.size(), eval);
+        }
+        else
+        {
+            size_t position = i % k;
+            g.peek(solution, p, position, eval);
+            g.commit(solution, p, position, eval);
+            g.delta_A_cap_S_all(solution, fdeltas);
+            g.peek_delta_A_cap_S(solution, solution[position]);
+        }
+        candidates.push_back(&p);
+    }
+    g.peek_many(solution, candidates, candidate_fdeltas);
+    cout << "No allocation by Eigen while evaluating and adding " << Dataset.size() << " points with k = " << k << endl;
+    cout << endl;
+}
+
+/**
+ * @brief Replace the points of a full solution set with every point of a dataset in turn, and check after each replacement that the
+ * log-determinant of the incrementally updated Cholesky factor matches a fresh factorization of M
+ * @param f: The submodular function, which is not modified
+ * @param Dataset: The dataset
+ * @param k: Cardinality constraint
+ * @param rounds: Number of passes over the dataset
+*/
+template<class F>
+void check_replacements(F &f, const vector<Point> &Dataset, size_t k, size_t rounds = 20)
+{
+    F g(f);
+    g.reserve(k+1);
+    vector<Point> solution;
+    CholeskyFactor<> fresh;
+    size_t replacements = 0;
+    double max_error = 0;
+    for(size_t round = 0; round < rounds; ++round)
+    {
+        for(size_t i = 0; i < Dataset.size(); ++i)
+        {
+            const Point &p = Dataset[i];
+            SubmodularFunction::Evaluation eval;
+            if(solution.size() < k)
+            {
+                g.peek(solution, p, solution.size(), eval);
+                g.commit(solution, p, solution.size(), eval);
+                continue;
+            }
+            size_t position = (i+round) % k;
+            g.peek(solution, p, position, eval);
+            g.commit(solution, p, position, eval);
+            ++replacements;
+
+            size_t n = solution.size();
+            fresh.factorize(g.M.topLeftCorner(n,n));
+            double error = abs(g.factor.log_det - fresh.log_det)/max(1.0, abs(fresh.log_det));
+            max_error = max(max_error, error);
+        }
+    }
+    cout << "Incremental log-determinant after " << replacements << " replacements with k = " << k << "\t largest relative error:\t" << max_error << endl;
+    cout << endl;
+    if(max_error > 1e-9)
+    {
+        cout << "The incremental Cholesky factor has drifted from M!!!" << endl;
+        exit(1);
+    }
+}
+
+//Largest cardinality constraint in run_algorithms(), which bounds the storage of the fixed-size submodular functions
+const int max_k = 50;
+
+//Options of a kernel submodular function, which its clones in all algorithms share
+struct KernelOptions
+{
+    //Maximum number of cached kernel values, 0 for no cache
+    size_t cache_capacity = 0;
+    //Directory of the Gram matrix files, empty for no Gram matrix
+    string gram_directory;
+    //Number of points of A kept exactly for FreeDisposal, 0 for no limit, beyond which A is summarized by random Fourier features
+    size_t A_limit = 0;
+};
+
+/**
+ * @brief Compare different algorithms with a kernel submodular function whose clones share a cache of kernel values or a precomputed Gram matrix
+ * @param f: The submodular function to be maximized
+ * @param Dataset: The dataset where different algorithms to be compared
+ * @param options: Options of the submodular function
+ * @param Compact: The coordinates of the dataset in reduced precision, which the algorithms read instead if not null
+*/
+template<class F>
+void run_algorithms_cached(F &f, const vector<Point> &Dataset, const KernelOptions &options, const CompactDataset *Compact)
+{
+    f.A_limit = options.A_limit;
+    if(!options.gram_directory.empty())
+    {
+        auto start = chrono::steady_clock::now();
+        f.use_gram_matrix(Dataset, options.gram_directory);
+        chrono::duration<double> runtime_seconds = chrono::steady_clock::now() - start;
+        cout << "Gram matrix:\t " << f.gram->path << (f.gram->built ? " built" : " mapped") << "\t bytes:\t" << f.gram->mapping_bytes << "\t runtime:\t" << runtime_seconds.count() << endl;
+        cout << endl;
+    }
+    else if(options.cache_capacity > 0)
+    {
+        f.cache = make_shared<KernelCache>(options.cache_capacity);
+    }
+
+    run_algorithms(f, Dataset, Compact);
+
+    if(f.cache)
+    {
+        cout << "Kernel cache:\t bytes:\t" << f.cache->bytes() << "\t hits:\t" << f.cache->hits << "\t misses:\t" << f.cache->misses << "\t hit rate:\t" << f.cache->hit_rate() << endl;
+        cout << endl;
+    }
+}
+
+/**
+ * @brief Time the algorithms that evaluate the same points with clones of a kernel submodular function, without and with a shared
+ * cache of kernel values, and check that the cache does not change their values
+ * @param f: The submodular function, which is not modified
+ * @param Dataset: The dataset
+ * @param k: Cardinality constraint
+ * @param capacity: Maximum number of cached kernel values
+*/
+template<class F>
+void benchmark_cache(F &f, const vector<Point> &Dataset, size_t k, size_t capacity)
+{
+    double fvals[2] = {0, 0};
+    for(bool cached : {false, true})
+    {
+        F g(f);
+        g.cache = cached ? make_shared<KernelCache>(capacity) : nullptr;
+        g.gram = nullptr;
+
+        //The sweep of OnlineAdaptive in run_algorithms(), whose runs evaluate the same pairs of points
+        double runtime = 0, fval = 0;
+        for(auto r : {1.0, 3.0, 5.0, 7.0, 9.0, 1.0*k})
+        {
+            OnlineAdaptiveT<F> alg(k, g, r);
+            auto res = evaluate_algorithm(alg, Dataset);
+            runtime += get<1>(res);
+            fval += get<0>(res);
+        }
+        fvals[cached] = fval;
+
+        cout << "Kernel cache " << (cached ? "on" : "off") << ":	 OnlineAdaptive with k = " << k << " and 6 values of r	 runtime:	" << runtime;
+        if(cached)
+        {
+            cout << "	 bytes:	" << g.cache->bytes() << "	 hit rate:	" << g.cache->hit_rate();
+        }
+        cout << endl;
+    }
+    cout << endl;
+    if(fvals[0] != fvals[1])
+    {
+        cout << "The kernel cache has changed the values of the solutions!!!" << endl;
+        exit(1);
+    }
+}
+
+/**
+ * @brief Compare different algorithms with the Gaussian submodular function, specialized on the dimension of the datasets it is used with
+ * @param dim: Dimension of the dataset
+ * @param Dataset: The dataset where different algorithms to be compared
+ * @param options: Options of the submodular function
+ * @param Compact: The coordinates of the dataset in reduced precision, which the algorithms read instead if not null
+*/
+void run_algorithms_gaussian(size_t dim, const vector<Point> &Dataset, const KernelOptions &options, const CompactDataset *Compact)
+{
+    switch(dim)
+    {
+        case 10:
+        {
+            GauVecSubFuncT<10,max_k> f(dim);
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+        case 29:
+        {
+            GauVecSubFuncT<29,max_k> f(dim);
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+        case 79:
+        {
+            GauVecSubFuncT<79,max_k> f(dim);
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+        default:
+        {
+            //No compiled instantiation for this dimension
+            GauVecSubFunc f(dim);
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Compare different algorithms with the Laplacian submodular function, specialized on the dimension of the datasets it is used with
+ * @param dim: Dimension of the dataset
+ * @param Dataset: The dataset where different algorithms to be compared
+ * @param options: Options of the submodular function
+ * @param Compact: The coordinates of the dataset in reduced precision, which the algorithms read instead if not null
+*/
+void run_algorithms_laplacian(size_t dim, const vector<Point> &Dataset, const KernelOptions &options, const CompactDataset *Compact)
+{
+    switch(dim)
+    {
+        case 4:
+        {
+            LapVecSubFuncT<4,max_k> f;
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+        default:
+        {
+            //No compiled instantiation for this dimension
+            LapVecSubFunc f;
+            run_algorithms_cached(f, Dataset, options, Compact);
+            break;
+        }
+    }
+}
+
 int main()
 {
     //When adding a new dataset, it is necessary to add both the reading method and the definition of the submodular function
@@ -141,12 +595,51 @@ int main()
             "dataset/YouTube_sampled.txt",
             "dataset/Twitter_sampled.txt",
     };
+    //Precision in which the algorithms read the coordinates of the datasets of numerical vectors, decoding one point at a time,
+    //Float64 to read the coordinates as they were loaded
+    CompactDataset::Precision storage_precision = CompactDataset::Float64;
+    //Whether to report the quality of the reduced-precision storage modes on the datasets of numerical vectors
+    bool report_reduced_precision = false;
+    //Whether to report the quality of the approximate log-determinant of FeatureVecSubFunc on the datasets of numerical vectors
+    bool report_approximate_logdet = false;
+    //Whether to use the sparse Gaussian kernel, whose values below sparse_tolerance*a beyond the cutoff radius are dropped
+    bool use_sparse_gaussian = false;
+    double sparse_tolerance = 1e-12;
+    //Maximum number of kernel values shared by the algorithms on a dataset of numerical vectors, 0 to compute all of them
+    size_t kernel_cache_capacity = 0;
+    //Whether to precompute the kernel values of all pairs of points of the datasets with at most gram_matrix_max_points points,
+    //in float, into a file of gram_directory that is mapped again by later runs
+    bool use_gram_matrix = false;
+    size_t gram_matrix_max_points = 50000;
+    string gram_directory = "gram";
+    //Number of points of A that FreeDisposal keeps exactly, 0 for no limit
+    size_t A_limit = 0;
+    //Whether to time the sweep of OnlineAdaptive on the datasets of numerical vectors without and with a cache of
+    //kernel_cache_benchmark_capacity kernel values
+    bool benchmark_kernel_cache = false;
+    size_t kernel_cache_benchmark_capacity = 1 << 20;
+    //Whether to time the distance primitives of Point on the datasets of numerical vectors and count their allocations
+    bool benchmark_point_primitives = false;
+    //Whether to check that the kernel submodular functions do not allocate while evaluating and adding points, which needs main.cpp
+    //to be built with -DEIGEN_RUNTIME_NO_MALLOC
+    bool check_kernel_no_malloc = false;
+    //Whether to check that the Cholesky factor of the kernel submodular functions does not drift from M over many replacements
+    bool check_kernel_replacements = false;
+    //Whether to read the datasets of numerical vectors from a binary cache next to their text files, written by the first run
+    //and mapped by later runs as long as it is newer than the text file
+    bool use_dataset_cache = false;
+
     for (size_t count = 0; count < file_paths.size(); ++count)
     {
         //Read datasets
         string file_path = file_paths[count];
         size_t dim;
         vector<Point> Dataset;
+        //Coordinates or words of the dataset, which its points refer to
+        VectorStore vector_store;
+        TokenStore token_store;
+        //Coordinates of the dataset in storage_precision, which the algorithms read instead of vector_store
+        optional<CompactDataset> Compact;
         cout << "Loading data from " << file_path << endl;
         if(
             file_path == "dataset/ForestCover_sampled.txt"||
@@ -155,15 +648,29 @@ int main()
             file_path == "dataset/YouTube_sampled.txt"
         )
         {
-            IOUtil::read_vectors(file_path.c_str(), dim, Dataset);
+            auto stats = use_dataset_cache ? IOUtil::read_vectors_cached(file_path.c_str(), dim, vector_store, Dataset)
+                : IOUtil::read_vectors(file_path.c_str(), dim, vector_store, Dataset);
+            cout << "Loaded " << stats.bytes/1e6 << " MB in " << stats.seconds << " s, " << stats.megabytes_per_second() << " MB/s" << endl;
             cout << "The dimension of Dataset is " << dim << endl;
             cout << "The size of Dataset is " << Dataset.size() << endl;
             cout << endl;
+            if(benchmark_point_primitives)
+            {
+                benchmark_distances(Dataset);
+            }
+            if(storage_precision != CompactDataset::Float64)
+            {
+                Compact.emplace(Dataset, storage_precision);
+                cout << "The coordinates are read in " << CompactDataset::name(storage_precision) << ", stored in " << Compact->bytes() << " bytes" << endl;
+                cout << endl;
+            }
         }
         else if(file_path == "dataset/Twitter_sampled.txt")
         {
-            IOUtil::read_words(file_path.c_str(), Dataset);
+            auto stats = IOUtil::read_words(file_path.c_str(), token_store, Dataset);
+            cout << "Loaded " << stats.bytes/1e6 << " MB in " << stats.seconds << " s, " << stats.megabytes_per_second() << " MB/s" << endl;
             cout << "The size of Dataset is " << Dataset.size() << endl;
+            cout << "The number of distinct words is " << token_store.words.size() << ", stored in " << token_store.bytes() << " bytes" << endl;
             cout << endl;
         }
         else
@@ -172,6 +679,16 @@ int main()
             exit(1);
         }
         
+        //Options of the kernel submodular functions
+        KernelOptions options;
+        options.cache_capacity = kernel_cache_capacity;
+        //The Gram matrix is built from the coordinates as they were loaded, so it is not used with reduced-precision coordinates
+        if(use_gram_matrix && !Compact && Dataset.size() <= gram_matrix_max_points)
+        {
+            options.gram_directory = gram_directory;
+        }
+        options.A_limit = A_limit;
+
         //Specify submodular functions
         if(
             file_path == "dataset/ForestCover_sampled.txt"||
@@ -179,13 +696,71 @@ int main()
             file_path == "dataset/KDDCup99_sampled.txt"
         )
         {
-            GauVecSubFunc f(dim);
-            run_algorithms(f, Dataset);
+            if(use_sparse_gaussian)
+            {
+                SparseGauVecSubFunc f(dim, SparseGauVecSubFunc::default_radius(dim, sparse_tolerance));
+                run_algorithms(f, Dataset, Compact ? &*Compact : nullptr);
+            }
+            else
+            {
+                run_algorithms_gaussian(dim, Dataset, options, Compact ? &*Compact : nullptr);
+            }
+            if(report_reduced_precision)
+            {
+                GauVecSubFunc f(dim);
+                report_precisions(f, Dataset, 10);
+            }
+            if(report_approximate_logdet)
+            {
+                GauVecSubFunc f(dim);
+                report_approximation(f, KernelRow::Gaussian, Dataset, 10);
+            }
+            if(benchmark_kernel_cache)
+            {
+                GauVecSubFunc f(dim);
+                benchmark_cache(f, Dataset, 10, kernel_cache_benchmark_capacity);
+            }
+            if(check_kernel_no_malloc)
+            {
+                GauVecSubFunc f(dim);
+                check_no_malloc(f, Dataset, 10);
+                GauVecSubFuncT<Dynamic,max_k> f_fixed(dim);
+                check_no_malloc(f_fixed, Dataset, 10);
+            }
+            if(check_kernel_replacements)
+            {
+                GauVecSubFunc f(dim);
+                check_replacements(f, Dataset, 10);
+            }
         }
         else if(file_path == "dataset/YouTube_sampled.txt")
         {
-            LapVecSubFunc f;
-            run_algorithms(f, Dataset);
+            run_algorithms_laplacian(dim, Dataset, options, Compact ? &*Compact : nullptr);
+            if(report_reduced_precision)
+            {
+                LapVecSubFunc f;
+                report_precisions(f, Dataset, 10);
+            }
+            if(report_approximate_logdet)
+            {
+                LapVecSubFunc f;
+                report_approximation(f, KernelRow::Laplacian, Dataset, 10);
+            }
+            if(benchmark_kernel_cache)
+            {
+                LapVecSubFunc f;
+                benchmark_cache(f, Dataset, 10, kernel_cache_benchmark_capacity);
+            }
+            if(check_kernel_no_malloc)
+            {
+                LapVecSubFunc f;
+                check_no_malloc(f, Dataset, 10);
+            }
+            if(check_kernel_replacements)
+            {
+                LapVecSubFunc f;
+                check_replacements(f, Dataset, 10);
+            }
         }
         else if(file_path == "dataset/Twitter_sampled.txt")
         {